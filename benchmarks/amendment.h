@@ -0,0 +1,93 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// AmendCommissionSchedule transactions with any number of rates and bounds, all with the
+// same context, fee and nonce
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace amendment {
+    inline void head(std::vector<uint8_t> &out, uint8_t major, uint32_t value) {
+        const uint8_t m = (uint8_t) (major << 5u);
+        if (value < 24) {
+            out.push_back(m | (uint8_t) value);
+        } else if (value <= UINT8_MAX) {
+            out.insert(out.end(), {(uint8_t) (m | 24u), (uint8_t) value});
+        } else {
+            out.insert(out.end(), {(uint8_t) (m | 25u), (uint8_t) (value >> 8u), (uint8_t) value});
+        }
+    }
+
+    inline void text(std::vector<uint8_t> &out, const char *s) {
+        head(out, 3, (uint32_t) strlen(s));
+        out.insert(out.end(), s, s + strlen(s));
+    }
+
+    inline void bytes(std::vector<uint8_t> &out, std::initializer_list<uint8_t> b) {
+        head(out, 2, (uint32_t) b.size());
+        out.insert(out.end(), b);
+    }
+
+    // Canonical CBOR: map keys sorted by length, then bytewise
+    inline std::vector<uint8_t> transaction(uint32_t rates, uint32_t bounds) {
+        const char context[] = "oasis-core/consensus: tx for chain abcdef0123456789";
+        std::vector<uint8_t> out;
+        out.push_back((uint8_t) strlen(context));
+        out.insert(out.end(), context, context + strlen(context));
+
+        head(out, 5, 4);
+        text(out, "fee");
+        head(out, 5, 2);
+        text(out, "gas");
+        head(out, 0, 1000);
+        text(out, "amount");
+        bytes(out, {0x77, 0x35, 0x94, 0x00});
+
+        text(out, "body");
+        head(out, 5, 1);
+        text(out, "amendment");
+        head(out, 5, 2);
+        text(out, "rates");
+        head(out, 4, rates);
+        for (uint32_t i = 0; i < rates; i++) {
+            head(out, 5, 2);
+            text(out, "rate");
+            bytes(out, {(uint8_t) (1 + i % 200), 0xef});
+            text(out, "start");
+            head(out, 0, 10 * i);
+        }
+        text(out, "bounds");
+        head(out, 4, bounds);
+        for (uint32_t i = 0; i < bounds; i++) {
+            head(out, 5, 3);
+            text(out, "start");
+            head(out, 0, 10 * i);
+            text(out, "rate_max");
+            bytes(out, {0x01, 0x86, 0xa0});
+            text(out, "rate_min");
+            bytes(out, {(uint8_t) (1 + i % 200)});
+        }
+
+        text(out, "nonce");
+        head(out, 0, 7);
+        text(out, "method");
+        text(out, "staking.AmendCommissionSchedule");
+        return out;
+    }
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Reviews commission schedules of growing length. Rates and bounds are indexed while
+// parsing, so the time per item and the time to reach the last step should stay flat
+
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "lib/parser.h"
+#include "lib/parser_impl.h"
+#include "amendment.h"
+
+namespace {
+    // Every page of every item of a schedule with range(0) rates and as many bounds
+    void BM_AmendmentItems(benchmark::State &state) {
+        const auto buffer = amendment::transaction((uint32_t) state.range(0), (uint32_t) state.range(0));
+        parser_context_t ctx;
+        char key[40];
+        char value[40];
+
+        if (parser_parse(&ctx, buffer.data(), buffer.size()) != parser_ok ||
+            parser_validate(&ctx) != parser_ok) {
+            state.SkipWithError("invalid schedule");
+            return;
+        }
+
+        const uint8_t numItems = parser_getNumItems(&ctx);
+        for (auto _ : state) {
+            for (uint8_t idx = 0; idx < numItems; idx++) {
+                uint8_t pageCount = 1;
+                for (uint8_t page = 0; page < pageCount; page++) {
+                    parser_getItem(&ctx, idx, key, sizeof(key), value, sizeof(value), page, &pageCount);
+                    benchmark::DoNotOptimize(value);
+                }
+            }
+        }
+        state.counters["items"] = numItems;
+        state.counters["per_item"] = benchmark::Counter(numItems, benchmark::Counter::kIsIterationInvariantRate |
+                                                                  benchmark::Counter::kInvert);
+    }
+
+    // Decoding the last rate and the last bound, without formatting them
+    void BM_AmendmentSeek(benchmark::State &state) {
+        const uint8_t steps = (uint8_t) state.range(0);
+        const auto buffer = amendment::transaction(steps, steps);
+        parser_state_t parsed;
+        if (parser_state_parse(&parsed, buffer.data(), buffer.size()) != parser_ok) {
+            state.SkipWithError("invalid schedule");
+            return;
+        }
+
+        for (auto _ : state) {
+            commissionRateStep_t rate;
+            commissionRateBoundStep_t bound;
+            _getCommissionRateStepAtIndex(&parsed.ctx, &parsed.tx, &rate, steps - 1);
+            _getCommissionBoundStepAtIndex(&parsed.ctx, &parsed.tx, &bound, steps - 1);
+            benchmark::DoNotOptimize(rate);
+            benchmark::DoNotOptimize(bound);
+        }
+    }
+}
+
+// 20 rates and 20 bounds are 40 of the MAX_AMENDMENT_STEPS
+BENCHMARK(BM_AmendmentItems)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(12)->Arg(16)->Arg(20);
+BENCHMARK(BM_AmendmentSeek)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(12)->Arg(16)->Arg(20);
+
+BENCHMARK_MAIN();
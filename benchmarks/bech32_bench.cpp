@@ -0,0 +1,69 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Encodes a public key as an oasis address with the generic encoder
+// and with the 32 bytes encoder that starts from the precomputed hrp state.
+// Reports cycles per address where a cycle counter exists
+
+#include <benchmark/benchmark.h>
+#include "bech32.h"
+#include "coin.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLE_COUNTER
+#endif
+
+namespace {
+    template<typename F>
+    void run(benchmark::State &state, F encode) {
+        uint8_t pk[32];
+        for (uint8_t i = 0; i < sizeof(pk); i++) {
+            pk[i] = (uint8_t) (0x9E * i + 0x37);
+        }
+
+        char output[128];
+#ifdef HAVE_CYCLE_COUNTER
+        const uint64_t start = __rdtsc();
+#endif
+        for (auto _ : state) {
+            encode(output, pk);
+            benchmark::DoNotOptimize(output);
+            benchmark::ClobberMemory();
+        }
+#ifdef HAVE_CYCLE_COUNTER
+        state.counters["cycles"] = benchmark::Counter((double) (__rdtsc() - start),
+                                                      benchmark::Counter::kAvgIterations);
+#endif
+    }
+
+    void BM_EncodeFromBytes(benchmark::State &state) {
+        run(state, [](char *output, const uint8_t *pk) {
+            bech32EncodeFromBytes(output, COIN_HRP, pk, 32);
+        });
+    }
+
+    void BM_EncodeFromBytes32(benchmark::State &state) {
+        run(state, [](char *output, const uint8_t *pk) {
+            bech32EncodeFromBytes32(output, COIN_HRP, COIN_HRP_STATE, pk);
+        });
+    }
+}
+
+BENCHMARK(BM_EncodeFromBytes);
+BENCHMARK(BM_EncodeFromBytes32);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,92 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Formats the largest value of each bignumBigEndian_to_decimal tier (u64, u128, limbs)
+// and compares it with double dabble, and the paged formatter with paging a full string.
+// Reports cycles per format where a cycle counter exists
+
+#include <cstring>
+#include <benchmark/benchmark.h>
+#include "bignum.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLE_COUNTER
+#endif
+
+namespace {
+    template<typename F>
+    void run(benchmark::State &state, F format) {
+        uint8_t value[BIGNUM_MAX_BYTES];
+        const auto len = (uint16_t) state.range(0);
+        memset(value, 0xFF, len);
+
+        char output[160];
+#ifdef HAVE_CYCLE_COUNTER
+        const uint64_t start = __rdtsc();
+#endif
+        for (auto _ : state) {
+            format(output, sizeof(output), value, len);
+            benchmark::DoNotOptimize(output);
+        }
+#ifdef HAVE_CYCLE_COUNTER
+        state.counters["cycles"] = benchmark::Counter((double) (__rdtsc() - start),
+                                                      benchmark::Counter::kAvgIterations);
+#endif
+    }
+
+    void BM_DoubleDabble(benchmark::State &state) {
+        run(state, [](char *output, uint16_t outputLen, const uint8_t *value, uint16_t len) {
+            uint8_t bcd[80];
+            bignumBigEndian_to_bcd(bcd, sizeof(bcd), value, len);
+            bignumBigEndian_bcdprint(output, outputLen, bcd, sizeof(bcd));
+        });
+    }
+
+    void BM_Decimal(benchmark::State &state) {
+        run(state, [](char *output, uint16_t outputLen, const uint8_t *value, uint16_t len) {
+            bignumBigEndian_to_decimal(output, outputLen, value, len);
+        });
+    }
+
+    // One 40 char page of a quantity with 9 decimals: full string then paging, or only the page
+    void BM_PageFromString(benchmark::State &state) {
+        run(state, [](char *output, uint16_t /* 40 char page */, const uint8_t *value, uint16_t len) {
+            char bignum[160];
+            char full[160];
+            uint8_t pageCount;
+            bignumBigEndian_to_decimal(bignum, sizeof(bignum), value, len);
+            MEMZERO(full, sizeof(full));
+            fpstr_to_str(full, bignum, 9);
+            pageString(output, 40, full, 0, &pageCount);
+        });
+    }
+
+    void BM_Page(benchmark::State &state) {
+        run(state, [](char *output, uint16_t /* 40 char page */, const uint8_t *value, uint16_t len) {
+            uint8_t pageCount;
+            bignumBigEndian_to_fpstr_page(output, 40, value, len, 9, "", 0, &pageCount);
+        });
+    }
+}
+
+// 8: u64 tier, 16: u128 tier, 32 and 64: limbs tier
+BENCHMARK(BM_DoubleDabble)->Arg(8)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK(BM_Decimal)->Arg(8)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK(BM_PageFromString)->Arg(8)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK(BM_Page)->Arg(8)->Arg(16)->Arg(32)->Arg(64);
+
+BENCHMARK_MAIN();
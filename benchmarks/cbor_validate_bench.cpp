@@ -0,0 +1,157 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Runs cbor_value_validate over whole transactions and over maps with many text keys.
+// sorted is basic plus the map order check, so the difference is the cost of that check.
+// canonical is what the parser uses. utf8 is canonical plus UTF-8 validation of text strings,
+// measured on maps of text (ascii: only ASCII, mixed: a two byte character every 32 bytes).
+// Reports cycles per validation where a cycle counter exists
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "cbor.h"
+#include "hexutils.h"
+#include "corpus.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLE_COUNTER
+#endif
+
+namespace {
+    void appendHead(std::vector<uint8_t> &out, uint8_t major, uint32_t value) {
+        major <<= 5u;
+        if (value < 24) {
+            out.push_back(major | value);
+        } else if (value < 0x100) {
+            out.push_back(major | 24u);
+            out.push_back(value);
+        } else {
+            out.push_back(major | 25u);
+            out.push_back(value >> 8u);
+            out.push_back(value & 0xFFu);
+        }
+    }
+
+    // CBOR of a transaction in the corpus (without the signer context)
+    std::vector<uint8_t> transaction(const corpus_entry_t &entry) {
+        std::vector<uint8_t> buffer(strlen(entry.hex) / 2);
+        parseHexString(entry.hex, buffer.data());
+        buffer.erase(buffer.begin(), buffer.begin() + 1 + buffer[0]);
+        return buffer;
+    }
+
+    // A map with keys of the same length that differ near the end, in canonical order
+    // ("0000000000000000", "0000000000000001", ...), the worst case of the order check
+    std::vector<uint8_t> manyKeys(uint32_t count, uint32_t keyLen) {
+        std::vector<uint8_t> out;
+        appendHead(out, 5, count);
+        for (uint32_t i = 0; i < count; i++) {
+            char key[40];
+            snprintf(key, sizeof(key), "descriptor_field_%015u", i);
+            const char *suffix = key + strlen(key) - keyLen;
+            appendHead(out, 3, keyLen);
+            out.insert(out.end(), suffix, suffix + keyLen);
+            appendHead(out, 0, i);
+        }
+        return out;
+    }
+
+    // count keys with text values of valueLen bytes
+    std::vector<uint8_t> textValues(uint32_t count, uint32_t valueLen, bool mixed) {
+        std::vector<uint8_t> out;
+        appendHead(out, 5, count);
+        for (uint32_t i = 0; i < count; i++) {
+            char key[24];
+            snprintf(key, sizeof(key), "field_%04u", i);
+            appendHead(out, 3, strlen(key));
+            out.insert(out.end(), key, key + strlen(key));
+
+            appendHead(out, 3, valueLen);
+            for (uint32_t j = 0; j < valueLen; j++) {
+                if (mixed && j % 32 == 30 && j + 1 < valueLen) {
+                    // U+00E9
+                    out.push_back(0xC3);
+                    out.push_back(0xA9);
+                    j++;
+                    continue;
+                }
+                out.push_back('a' + (i + j) % 26);
+            }
+        }
+        return out;
+    }
+
+    void BM_Validate(benchmark::State &state, std::vector<uint8_t> cbor, uint32_t flags) {
+        CborParser parser;
+        CborValue it;
+#ifdef HAVE_CYCLE_COUNTER
+        const uint64_t start = __rdtsc();
+#endif
+        for (auto _ : state) {
+            cbor_parser_init(cbor.data(), cbor.size(), 0, &parser, &it);
+            const CborError err = cbor_value_validate(&it, flags);
+            if (err != CborNoError) {
+                state.SkipWithError("invalid cbor");
+                break;
+            }
+        }
+#ifdef HAVE_CYCLE_COUNTER
+        state.counters["cycles"] = benchmark::Counter((double) (__rdtsc() - start),
+                                                      benchmark::Counter::kAvgIterations);
+#endif
+        state.SetBytesProcessed(state.iterations() * cbor.size());
+    }
+
+    void registerAll(const std::string &name, const std::vector<uint8_t> &cbor) {
+        benchmark::RegisterBenchmark(("canonical/" + name).c_str(), BM_Validate, cbor,
+                                     (uint32_t) CborValidateCanonicalFormat);
+        benchmark::RegisterBenchmark(("sorted/" + name).c_str(), BM_Validate, cbor,
+                                     (uint32_t) (CborValidateBasic | CborValidateMapIsSorted));
+        benchmark::RegisterBenchmark(("basic/" + name).c_str(), BM_Validate, cbor,
+                                     (uint32_t) CborValidateBasic);
+    }
+}
+
+int main(int argc, char **argv) {
+    for (const auto &entry : corpus) {
+        registerAll(entry.name, transaction(entry));
+    }
+    for (uint32_t count : {16, 64, 256}) {
+        for (uint32_t keyLen : {8, 16, 23}) {
+            registerAll("keys_" + std::to_string(count) + "x" + std::to_string(keyLen),
+                         manyKeys(count, keyLen));
+        }
+    }
+
+    for (uint32_t valueLen : {16, 64, 256}) {
+        for (bool mixed : {false, true}) {
+            const auto cbor = textValues(32, valueLen, mixed);
+            const std::string name = std::string(mixed ? "mixed_" : "ascii_") + "32x" + std::to_string(valueLen);
+            benchmark::RegisterBenchmark(("utf8/" + name).c_str(), BM_Validate, cbor,
+                                         (uint32_t) (CborValidateCanonicalFormat | CborValidateUtf8));
+            benchmark::RegisterBenchmark(("canonical/" + name).c_str(), BM_Validate, cbor,
+                                         (uint32_t) CborValidateCanonicalFormat);
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Transaction buffers as received by the app: context length, signer context and
+// canonical CBOR as encoded by oasis-core. Keys and amounts are arbitrary.
+// There is at least one transaction per oasis_methods_e, plus an entity descriptor.
+
+typedef struct {
+    const char *name;
+    const char *hex;
+} corpus_entry_t;
+
+static const corpus_entry_t corpus[] = {
+    {"transfer",   // staking.Transfer, 179 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a463666565a2636761731903e866616d6f756e74447735940064626f6479a267786665725f746f5820442082"
+     "3cfde6f1c26b30f90ec7dd01e4887534a20f0b0d04c36ed80e71e0fd776b786665725f746f6b656e734a029d42b64e76"
+     "714244cb656e6f6e636507666d6574686f64707374616b696e672e5472616e73666572"},
+    {"burn",   // staking.Burn, 150 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a463666565a2636761731903e866616d6f756e74447735940064626f6479a16b6275726e5f746f6b656e7358"
+     "1a0100000000000000000000000000000000000000000000000000656e6f6e636507666d6574686f646c7374616b696e"
+     "672e4275726e"},
+    {"add_escrow",   // staking.AddEscrow, 187 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a463666565a2636761731903e866616d6f756e74447735940064626f6479a26d657363726f775f746f6b656e"
+     "73480de0b6b3a76400006e657363726f775f6163636f756e745820fa0ff0169dc9575674066676cfb0b4eb8902c44269"
+     "da1cf6ba66d3f8b6d4b100656e6f6e636507666d6574686f64717374616b696e672e416464457363726f77"},
+    {"reclaim_escrow",   // staking.ReclaimEscrow, 185 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a463666565a2636761731903e866616d6f756e74447735940064626f6479a26e657363726f775f6163636f75"
+     "6e745820a9ea0e755a5c2e8210242a08e7078f7f89385eb09423555182568b96e8a4fef26e7265636c61696d5f736861"
+     "7265734105656e6f6e636507666d6574686f64757374616b696e672e5265636c61696d457363726f77"},
+    {"amend_commission_3_2",   // staking.AmendCommissionSchedule, 266 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a463666565a2636761731903e866616d6f756e74447735940064626f6479a169616d656e646d656e74a26572"
+     "6174657383a26472617465410765737461727400a264726174654203ef6573746172740aa264726174654207d7657374"
+     "6172741466626f756e647382a36573746172740068726174655f6d6178430186a068726174655f6d696e40a365737461"
+     "72740b68726174655f6d61784301869f68726174655f6d696e4103656e6f6e636507666d6574686f64781f7374616b69"
+     "6e672e416d656e64436f6d6d697373696f6e5363686564756c65"},
+    {"amend_commission_20_20",   // staking.AmendCommissionSchedule, 1148 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a463666565a2636761731903e866616d6f756e74447735940064626f6479a169616d656e646d656e74a26572"
+     "6174657394a26472617465410765737461727400a264726174654203ef6573746172740aa264726174654207d7657374"
+     "61727414a26472617465420bbf657374617274181ea26472617465420fa76573746172741828a2647261746542138f65"
+     "73746172741832a26472617465421777657374617274183ca26472617465421b5f6573746172741846a2647261746542"
+     "1f476573746172741850a2647261746542232f657374617274185aa264726174654227176573746172741864a2647261"
+     "7465422aff657374617274186ea26472617465422ee76573746172741878a264726174654232cf6573746172741882a2"
+     "64726174654236b7657374617274188ca26472617465423a9f6573746172741896a26472617465423e87657374617274"
+     "18a0a2647261746542426f65737461727418aaa2647261746542465765737461727418b4a26472617465424a3f657374"
+     "61727418be66626f756e647394a36573746172740068726174655f6d6178430186a068726174655f6d696e40a3657374"
+     "6172740b68726174655f6d61784301869f68726174655f6d696e4103a36573746172741668726174655f6d6178430186"
+     "9e68726174655f6d696e4106a3657374617274182168726174655f6d61784301869d68726174655f6d696e4109a36573"
+     "74617274182c68726174655f6d61784301869c68726174655f6d696e410ca3657374617274183768726174655f6d6178"
+     "4301869b68726174655f6d696e410fa3657374617274184268726174655f6d61784301869a68726174655f6d696e4112"
+     "a3657374617274184d68726174655f6d61784301869968726174655f6d696e4115a3657374617274185868726174655f"
+     "6d61784301869868726174655f6d696e4118a3657374617274186368726174655f6d61784301869768726174655f6d69"
+     "6e411ba3657374617274186e68726174655f6d61784301869668726174655f6d696e411ea36573746172741879687261"
+     "74655f6d61784301869568726174655f6d696e4121a3657374617274188468726174655f6d6178430186946872617465"
+     "5f6d696e4124a3657374617274188f68726174655f6d61784301869368726174655f6d696e4127a3657374617274189a"
+     "68726174655f6d61784301869268726174655f6d696e412aa365737461727418a568726174655f6d6178430186916872"
+     "6174655f6d696e412da365737461727418b068726174655f6d61784301869068726174655f6d696e4130a36573746172"
+     "7418bb68726174655f6d61784301868f68726174655f6d696e4133a365737461727418c668726174655f6d6178430186"
+     "8e68726174655f6d696e4136a365737461727418d168726174655f6d61784301868d68726174655f6d696e4139656e6f"
+     "6e636507666d6574686f64781f7374616b696e672e416d656e64436f6d6d697373696f6e5363686564756c65"},
+    {"deregister_entity",   // registry.DeregisterEntity, 118 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a363666565a2636761731903e866616d6f756e744477359400656e6f6e636507666d6574686f647819726567"
+     "69737472792e44657265676973746572456e74697479"},
+    {"unfreeze_node",   // registry.UnfreezeNode, 161 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a463666565a2636761731903e866616d6f756e74447735940064626f6479a1676e6f64655f696458203a0c9f"
+     "c5afd7608437816bdd0a7309cb4a1252e4da70e6720fcaa4da1e98406c656e6f6e636507666d6574686f647572656769"
+     "737472792e556e667265657a654e6f6465"},
+    {"register_entity_1",   // registry.RegisterEntity, 382 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a463666565a2636761731903e866616d6f756e74447735940064626f6479a2697369676e6174757265a26973"
+     "69676e61747572655840187e8120e4dc80e0e805caad5784f80cd5091fb5464046848dcbcd582d77f8035aa2e0737aa0"
+     "fdf573d3ac8c701824bc51689f9899be54ed2b3fc15a4f80da6f6a7075626c69635f6b657958201afdc9b2c454142e82"
+     "33882a4729e37bc3ddcb54a6e040f96c3ddcd13c978e7f73756e747275737465645f7261775f76616c7565586ba36269"
+     "645820f0b6845d6a9d657eb8298f2de52ead74c79d15a75fa29b7dab332f7d700a7ccd656e6f64657381582025892426"
+     "0b0594b7fcf04e33a727585b4c48a39c369640694810a1695b99dd507819616c6c6f775f656e746974795f7369676e65"
+     "645f6e6f646573f5656e6f6e636507666d6574686f647772656769737472792e5265676973746572456e74697479"},
+    {"register_entity_16",   // registry.RegisterEntity, 893 bytes
+     "336f617369732d636f72652f636f6e73656e7375733a20747820666f7220636861696e20616263646566303132333435"
+     "36373839a463666565a2636761731903e866616d6f756e74447735940064626f6479a2697369676e6174757265a26973"
+     "69676e617475726558404e1d0fcfc3d54642257bc3479267cbb65b739849b2fb952d996aed0b9434bee3821d1aa15143"
+     "3439de7d6acb3e6cc44482013d67c1f67689135577d28cd7cc8b6a7075626c69635f6b65795820fc32425f08e816fa6d"
+     "c9ac7c302715d8e2605861c5b86477b821ae1aea165a4b73756e747275737465645f7261775f76616c7565590269a362"
+     "6964582069a9adc8f63542e50f955066bdc7a631d1b040211699a0d598a3b48ba6043e4c656e6f646573905820a2a6a7"
+     "23e78ff5e8bac2281c4418fb807dadb9bdce9dedae550e4b807144395e5820d21932883668852228256f58dd0bbcf991"
+     "7066fc78d9e7bb60f62583d06704c25820f927ced914b4ea036199023d9aa190d2d19de79a43e347538104d912bcd7cd"
+     "905820092e2e02c489ed8bbef6acc6e93bf7b54ad44b095885bc4193d38493d78cddab5820f86efbcdd92e2042694c75"
+     "0d34814ff532cc5f012dda1a6fd8b11834d63c878e58205bf5186d2cc73fe596fec93bf5364cc5675583d593fc6dacf8"
+     "3404b1881ce199582033758c8a7ed24b428363d01d4cd38a8ff59c88fb6dffbcf07bad5a5ce64c1da65820456da1fcf5"
+     "a83c414783732d19583b73669dd8a7020a9c702b728fae89c20b3e5820a8b1473a804915b1272f3499a27f8919b90f28"
+     "47ccbe7b30a88c04a439b4408a5820cf2ef3d6c99a709a441b38597b6ede8c0a808a86f240ce35bf23b90f9de4434f58"
+     "2026486ef7abba95514fc3e1cf3c4a8a97040443c233eb0fddd88dbdd1cfec1b325820f11300153847b68ab6f27d7a36"
+     "b7513b14a0d8b1811cded4c0b796aee179491c5820ae3a58f9ae3e0bf56bc459cb74337faba87decf1bdfc63dde1cc3d"
+     "f988404c065820c0d4370d265deac1934f4e368209edcb74c8027fd8515baf7a265259c00b6fda5820781461277ecbee"
+     "3c18c62d30f5177a060a9fee8ed45544a2e5d555cac766fd8e5820b84d848f592ab8ac49848281b2c48eef064c428173"
+     "642465db7a47ebc8642a277819616c6c6f775f656e746974795f7369676e65645f6e6f646573f4656e6f6e636507666d"
+     "6574686f647772656769737472792e5265676973746572456e74697479"},
+    {"entity_5",   // entity, 280 bytes
+     "246f617369732d636f72652f72656769737472793a20726567697374657220656e74697479a36269645820c10261e00a"
+     "0f7c856958914b668b9f80e456b6fbd73e6ac46891370c3c069745656e6f64657385582026bf9fdfb6a5003fe2e6b39c"
+     "ccadfc39c1c368018e65ecd19c57e665b801c7da5820cfac22fc7e940ad04fcb8a5b2505b287d29b4dec84f856ef178a"
+     "32d823b522e258200a54522fcd8d9b6a6a79aa892326bcef1956988ab676c8cc58f784a871847d0f5820cea2dd7f8961"
+     "2554e34b86eb534646e1b89ecd7b3b699c223674cba4fc335f1758201c0b6e11fde2af8c3c583071cc77fde6c1567678"
+     "91ecc76ce784a9fe386d28177819616c6c6f775f656e746974795f7369676e65645f6e6f646573f5"},
+};
@@ -0,0 +1,107 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Replays the corpus through each parser stage and reports time per operation
+// and bytes per second (transaction bytes processed per second of that stage)
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "hexutils.h"
+#include "lib/parser.h"
+#include "corpus.h"
+
+namespace {
+    std::vector<uint8_t> decode(const corpus_entry_t &entry) {
+        std::vector<uint8_t> buffer(strlen(entry.hex) / 2);
+        parseHexString(entry.hex, buffer.data());
+        return buffer;
+    }
+
+    void BM_Parse(benchmark::State &state, const corpus_entry_t *entry) {
+        const auto buffer = decode(*entry);
+        parser_context_t ctx;
+
+        for (auto _ : state) {
+            parser_error_t err = parser_parse(&ctx, buffer.data(), buffer.size());
+            if (err != parser_ok) {
+                state.SkipWithError(parser_getErrorDescription(err));
+                break;
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * buffer.size());
+    }
+
+    void BM_Validate(benchmark::State &state, const corpus_entry_t *entry) {
+        const auto buffer = decode(*entry);
+        parser_context_t ctx;
+
+        parser_error_t err = parser_parse(&ctx, buffer.data(), buffer.size());
+        if (err != parser_ok) {
+            state.SkipWithError(parser_getErrorDescription(err));
+        }
+
+        for (auto _ : state) {
+            err = parser_validate(&ctx);
+            if (err != parser_ok) {
+                state.SkipWithError(parser_getErrorDescription(err));
+                break;
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * buffer.size());
+    }
+
+    // Renders every page of every item, as the UI does when the user reviews a transaction
+    void BM_GetItems(benchmark::State &state, const corpus_entry_t *entry) {
+        const auto buffer = decode(*entry);
+        parser_context_t ctx;
+        char key[40];
+        char value[40];
+
+        parser_error_t err = parser_parse(&ctx, buffer.data(), buffer.size());
+        if (err == parser_ok) {
+            err = parser_validate(&ctx);
+        }
+        if (err != parser_ok) {
+            state.SkipWithError(parser_getErrorDescription(err));
+        }
+
+        for (auto _ : state) {
+            const uint8_t numItems = parser_getNumItems(&ctx);
+            for (uint8_t idx = 0; idx < numItems; idx++) {
+                uint8_t pageCount = 1;
+                for (uint8_t page = 0; page < pageCount; page++) {
+                    err = parser_getItem(&ctx, idx, key, sizeof(key), value, sizeof(value), page, &pageCount);
+                    benchmark::DoNotOptimize(value);
+                }
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * buffer.size());
+    }
+}
+
+int main(int argc, char **argv) {
+    for (const auto &entry : corpus) {
+        const std::string name = entry.name;
+        benchmark::RegisterBenchmark(("parse/" + name).c_str(), BM_Parse, &entry);
+        benchmark::RegisterBenchmark(("validate/" + name).c_str(), BM_Validate, &entry);
+        benchmark::RegisterBenchmark(("getItem/" + name).c_str(), BM_GetItems, &entry);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
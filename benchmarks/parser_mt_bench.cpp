@@ -0,0 +1,106 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Parses, validates and renders every page of a large corpus split across threads, each one
+// with its own parser_state_t. An iteration is the whole corpus, items_per_second is the total
+// throughput and tx/thread the throughput of one thread
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "hexutils.h"
+#include "lib/parser.h"
+#include "corpus.h"
+
+namespace {
+    // Copies of each corpus entry that parses, in their own allocations
+    constexpr size_t COPIES = 1024;
+
+    std::vector<std::vector<uint8_t>> largeCorpus() {
+        std::vector<std::vector<uint8_t>> txs;
+        for (size_t copy = 0; copy < COPIES; copy++) {
+            for (const auto &entry : corpus) {
+                std::vector<uint8_t> buffer(strlen(entry.hex) / 2);
+                parseHexString(entry.hex, buffer.data());
+
+                parser_state_t state;
+                if (parser_state_parse(&state, buffer.data(), buffer.size()) == parser_ok &&
+                    parser_state_validate(&state) == parser_ok) {
+                    txs.push_back(std::move(buffer));
+                }
+            }
+        }
+        return txs;
+    }
+
+    const std::vector<std::vector<uint8_t>> &txs() {
+        static const auto corpus = largeCorpus();
+        return corpus;
+    }
+
+    void BM_ReviewCorpus(benchmark::State &state) {
+        const auto &corpus = txs();
+        const size_t step = state.threads();
+        parser_state_t parser;
+        char key[40];
+        char value[40];
+        size_t count = 0;
+        size_t bytes = 0;
+
+        for (auto _ : state) {
+            for (size_t i = state.thread_index(); i < corpus.size(); i += step) {
+                const auto &tx = corpus[i];
+                if (parser_state_parse(&parser, tx.data(), tx.size()) != parser_ok ||
+                    parser_state_validate(&parser) != parser_ok) {
+                    state.SkipWithError("invalid transaction");
+                    return;
+                }
+
+                const uint8_t numItems = parser_state_getNumItems(&parser);
+                for (uint8_t idx = 0; idx < numItems; idx++) {
+                    uint8_t pageCount = 1;
+                    for (uint8_t page = 0; page < pageCount; page++) {
+                        parser_state_getItem(&parser, idx, key, sizeof(key), value, sizeof(value),
+                                             page, &pageCount);
+                        benchmark::DoNotOptimize(value);
+                    }
+                }
+                count++;
+                bytes += tx.size();
+            }
+        }
+
+        state.SetItemsProcessed(count);
+        state.SetBytesProcessed(bytes);
+        state.counters["tx/thread"] = benchmark::Counter((double) count,
+                                                         benchmark::Counter::kIsRate | benchmark::Counter::kAvgThreads);
+    }
+}
+
+int main(int argc, char **argv) {
+    // Every thread count up to the cores, so tx/thread can be compared one step at a time
+    const int cores = (int) std::max(1u, std::thread::hardware_concurrency());
+    benchmark::RegisterBenchmark("review_corpus", BM_ReviewCorpus)
+            ->DenseThreadRange(1, cores)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
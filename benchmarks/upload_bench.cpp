@@ -0,0 +1,228 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Replays transaction uploads chunk by chunk and reports the flash traffic
+// measured by the NVM simulator (nvm_sim.h), per upload:
+//   nvm_calls, page_writes, partial_pages, bytes_written, sim_ms (modelled write time)
+//
+// Strategies:
+//   0 per_chunk: one flash write per chunk after RAM overflows, as buffering did before staging
+//   1 staged:    buffering as it is, whole pages staged in RAM
+//   2 declared:  staged, and the init chunk carries the total length (tx_reserve)
+//
+// nanos: the app tx buffer through tx_append (host builds use the Nano S sizes)
+// nanox: buffering with the Nano X sizes, as tx_append would use it. Host builds stage with the
+//        Nano S page size, the staging buffer is a multiple of 512 so commits are the same
+
+#include <cstring>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "buffering.h"
+#include "zxmacros.h"
+#include "hexutils.h"
+#include "nvm_sim.h"
+#include "tx.h"
+#include "corpus.h"
+
+namespace {
+    enum strategy_e {
+        strategy_per_chunk,
+        strategy_staged,
+        strategy_declared,
+    };
+
+    enum chunking_e {
+        chunks_250,         // host libraries send 250 byte chunks
+        chunks_255,         // largest APDU payload
+        chunks_mixed,       // 32 to 255 bytes
+    };
+
+    std::vector<uint16_t> chunkSizes(size_t total, chunking_e chunking) {
+        std::vector<uint16_t> sizes;
+        uint32_t seed = 12345;
+        while (total > 0) {
+            size_t n = 250;
+            if (chunking == chunks_255) {
+                n = 255;
+            } else if (chunking == chunks_mixed) {
+                seed = seed * 1103515245u + 12345u;
+                n = 32 + (seed >> 16u) % 224;
+            }
+            if (n > total) {
+                n = total;
+            }
+            sizes.push_back((uint16_t) n);
+            total -= n;
+        }
+        return sizes;
+    }
+
+    std::vector<uint8_t> payload(size_t len) {
+        // Real transactions when there is one of that size, arbitrary bytes otherwise
+        for (const auto &entry : corpus) {
+            if (strlen(entry.hex) / 2 == len) {
+                std::vector<uint8_t> tx(len);
+                parseHexString(entry.hex, tx.data());
+                return tx;
+            }
+        }
+        std::vector<uint8_t> data(len);
+        for (size_t i = 0; i < len; i++) {
+            data[i] = (uint8_t) (i * 31 + 7);
+        }
+        return data;
+    }
+
+    // Buffering before staging: RAM until it overflows, then copy it to flash and write every chunk
+    void uploadPerChunk(uint8_t *flash, size_t ramSize, const std::vector<uint8_t> &data,
+                        const std::vector<uint16_t> &sizes) {
+        size_t offset = 0;
+        bool inFlash = false;
+        for (uint16_t n : sizes) {
+            if (!inFlash && offset + n > ramSize) {
+                inFlash = true;
+                if (offset > 0) {
+                    MEMCPY_NV(flash, data.data(), offset);
+                }
+            }
+            if (inFlash) {
+                MEMCPY_NV(flash + offset, data.data() + offset, n);
+            }
+            offset += n;
+        }
+    }
+
+    void report(benchmark::State &state, const nvm_sim_stats_t &total, size_t bytes) {
+        const double uploads = (double) state.iterations();
+        state.counters["nvm_calls"] = total.calls / uploads;
+        state.counters["page_writes"] = total.page_writes / uploads;
+        state.counters["partial_pages"] = total.partial_page_writes / uploads;
+        state.counters["bytes_written"] = total.bytes_written / uploads;
+        state.counters["sim_ms"] = (double) total.latency_us / 1000.0 / uploads;
+        state.SetBytesProcessed((int64_t) (state.iterations() * bytes));
+    }
+
+    void accumulate(nvm_sim_stats_t *total) {
+        const nvm_sim_stats_t *stats = nvm_sim_get_stats();
+        total->calls += stats->calls;
+        total->page_writes += stats->page_writes;
+        total->partial_page_writes += stats->partial_page_writes;
+        total->bytes_written += stats->bytes_written;
+        total->latency_us += stats->latency_us;
+    }
+
+    void BM_UploadNanoS(benchmark::State &state) {
+        const auto len = (size_t) state.range(0);
+        const auto chunking = (chunking_e) state.range(1);
+        const auto strategy = (strategy_e) state.range(2);
+        auto data = payload(len);
+        const auto sizes = chunkSizes(len, chunking);
+        alignas(64) static uint8_t flash[8192];
+
+        nvm_sim_set_profile(&nvm_sim_profile_nanos);
+        nvm_sim_stats_t total = {};
+        for (auto _ : state) {
+            nvm_sim_reset_stats();
+            if (strategy == strategy_per_chunk) {
+                uploadPerChunk(flash, 384, data, sizes);
+                accumulate(&total);
+                continue;
+            }
+
+            tx_initialize();
+            tx_reset();
+            if (strategy == strategy_declared && !tx_reserve(len)) {
+                state.SkipWithError("too big");
+                return;
+            }
+
+            size_t offset = 0;
+            for (uint16_t n : sizes) {
+                if (tx_append(data.data() + offset, n) != n) {
+                    state.SkipWithError("append failed");
+                    return;
+                }
+                offset += n;
+            }
+            tx_flush();
+            accumulate(&total);
+        }
+        report(state, total, len);
+    }
+
+    void BM_UploadNanoX(benchmark::State &state) {
+        const auto len = (size_t) state.range(0);
+        const auto chunking = (chunking_e) state.range(1);
+        const auto strategy = (strategy_e) state.range(2);
+        auto data = payload(len);
+        const auto sizes = chunkSizes(len, chunking);
+
+        static uint8_t ram[8192];
+        alignas(512) static uint8_t flash[16384];
+        static_assert(sizeof(ram) % 512 == 0, "commits have to be whole Nano X pages");
+
+        nvm_sim_set_profile(&nvm_sim_profile_nanox);
+        nvm_sim_stats_t total = {};
+        for (auto _ : state) {
+            nvm_sim_reset_stats();
+            if (strategy == strategy_per_chunk) {
+                uploadPerChunk(flash, sizeof(ram), data, sizes);
+                accumulate(&total);
+                continue;
+            }
+
+            buffering_init(ram, sizeof(ram), flash, sizeof(flash));
+            if (strategy == strategy_declared && !buffering_reserve(len)) {
+                state.SkipWithError("too big");
+                return;
+            }
+
+            size_t offset = 0;
+            for (uint16_t n : sizes) {
+                if (buffering_append(data.data() + offset, n) != n) {
+                    state.SkipWithError("append failed");
+                    return;
+                }
+                offset += n;
+            }
+            buffering_flush();
+            accumulate(&total);
+        }
+        report(state, total, len);
+        nvm_sim_set_profile(&nvm_sim_profile_nanos);
+    }
+
+    void uploadArgs(benchmark::internal::Benchmark *b, const std::vector<int64_t> &lengths) {
+        b->ArgNames({"bytes", "chunking", "strategy"});
+        for (int64_t len : lengths) {
+            for (int64_t chunking : {chunks_250, chunks_255, chunks_mixed}) {
+                for (int64_t strategy : {strategy_per_chunk, strategy_staged, strategy_declared}) {
+                    b->Args({len, chunking, strategy});
+                }
+            }
+        }
+    }
+}
+
+// 893: register_entity_16, 1148: amend_commission_20_20, then large entity registrations
+BENCHMARK(BM_UploadNanoS)->Apply([](benchmark::internal::Benchmark *b) {
+    uploadArgs(b, {893, 1148, 2048, 4096, 8000});
+});
+BENCHMARK(BM_UploadNanoX)->Apply([](benchmark::internal::Benchmark *b) {
+    uploadArgs(b, {1148, 8000, 9000, 16000});
+});
+
+BENCHMARK_MAIN();
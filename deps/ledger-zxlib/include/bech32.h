@@ -15,6 +15,9 @@
 ********************************************************************************/
 #pragma once
 
+#include <stdint.h>
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -27,6 +30,23 @@ void bech32EncodeFromBytes(char *output,
                            const uint8_t *data,
                            size_t data_len);
 
+// 32 bytes give 51 groups of 5 bits (the last bit is dropped, as convert_bits does without padding)
+// the address is hrp + '1' + 51 + 6 checksum chars, at most 90 chars
+#define BECH32_BYTES32_MAX_HRP_LEN 32
+#define BECH32_BYTES32_ADDR_LEN(hrpLen) ((hrpLen) + 1 + 51 + 6)
+
+// checksum state after the hrp, to precompute the state of a fixed hrp
+// returns 0 if the hrp is not valid
+uint32_t bech32HrpState(const char *hrp);
+
+// same output as bech32EncodeFromBytes for 32 bytes of data
+// hrpState must be bech32HrpState(hrp)
+// output needs BECH32_BYTES32_ADDR_LEN(strlen(hrp)) + 1 bytes
+void bech32EncodeFromBytes32(char *output,
+                             const char *hrp,
+                             uint32_t hrpState,
+                             const uint8_t data[32]);
+
 #ifdef __cplusplus
 }
 #endif
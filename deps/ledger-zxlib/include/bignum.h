@@ -29,6 +29,29 @@ void bignumLittleEndian_to_bcd(uint8_t *bcdOut, uint16_t bcdOutLen, const uint8_
 bool_t bignumBigEndian_bcdprint(char *outBuffer, uint16_t outBufferLen, const uint8_t *bcdIn, uint16_t bcdInLen);
 void bignumBigEndian_to_bcd(uint8_t *bcdOut, uint16_t bcdOutLen, const uint8_t *binValue, uint16_t binValueLen);
 
+// Largest value accepted by the decimal formatters (512 bits, 155 digits)
+#define BIGNUM_MAX_BYTES 64
+// 155 digits in base 10^9 chunks
+#define BIGNUM_MAX_CHUNKS 18
+
+// Converts to base 10^9, least significant chunk first. Returns the number of chunks (0 if too big)
+uint8_t bignumBigEndian_to_chunks(uint32_t chunks[BIGNUM_MAX_CHUNKS], const uint8_t *binValue, uint16_t binValueLen);
+
+// Same output as bignumBigEndian_to_bcd + bignumBigEndian_bcdprint, without the bcd buffer
+// Returns false and writes "ERR" if the digits do not fit in outBuffer
+bool_t bignumBigEndian_to_decimal(char *outBuffer, uint16_t outBufferLen, const uint8_t *binValue, uint16_t binValueLen);
+
+// Same output as formatting with bignumBigEndian_to_decimal, fpstr_to_str and appending suffix,
+// then pageStringExt, but only the requested page is written
+bool_t bignumBigEndian_to_fpstr_page(char *outValue, uint16_t outValueLen,
+                                     const uint8_t *binValue, uint16_t binValueLen,
+                                     uint8_t decimals, const char *suffix,
+                                     uint8_t pageIdx, uint8_t *pageCount);
+
+// Length of the string bignumBigEndian_to_fpstr_page pages (0 if the value is too big)
+uint16_t bignumBigEndian_to_fpstr_len(const uint8_t *binValue, uint16_t binValueLen,
+                                      uint8_t decimals, uint16_t suffixLen);
+
 
 #ifdef __cplusplus
 }
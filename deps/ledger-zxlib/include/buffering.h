@@ -24,6 +24,15 @@ extern "C" {
 #include <stdint.h>
 #include <stdio.h>
 
+// Flash is written in whole pages of this size, the flash buffer must be aligned to it
+#ifndef BUFFERING_FLASH_PAGE_SIZE
+#if defined(TARGET_NANOX)
+#define BUFFERING_FLASH_PAGE_SIZE 512
+#else
+#define BUFFERING_FLASH_PAGE_SIZE 64
+#endif
+#endif
+
 typedef struct {
     uint8_t *data;
     uint16_t size;
@@ -44,12 +53,27 @@ void buffering_init(uint8_t *ram_buffer,
 /// Reset buffer
 void buffering_reset();
 
+/// Declare the total length of the data before appending it
+/// The buffer that can hold it is used from the start, so data is never moved from RAM to flash,
+/// and appends beyond the declared length are rejected. Must be called before any append.
+/// \param total_length
+/// \return 1 if the data fits, 0 otherwise
+int buffering_reserve(uint32_t total_length);
+
 /// Append data to the buffer
 /// \param data
 /// \param length
 /// \return the number of appended bytes
 int buffering_append(uint8_t *data, int length);
 
+/// Write data that is still staged in RAM to flash
+/// Call it after the last append, before reading the buffer
+void buffering_flush();
+
+/// Number of bytes that can already be read from buffering_get_buffer()->data
+/// It can be less than pos while flash is in use, buffering_flush writes the rest
+uint16_t buffering_get_committed_length();
+
 /// buffering_get_ram_buffer
 /// \return
 buffer_state_t *buffering_get_ram_buffer();
@@ -59,6 +83,7 @@ buffer_state_t *buffering_get_ram_buffer();
 buffer_state_t *buffering_get_flash_buffer();
 
 /// buffering_get_buffer
+/// While flash is in use, data is contiguous up to pos only after buffering_flush
 /// \return
 buffer_state_t *buffering_get_buffer();
 
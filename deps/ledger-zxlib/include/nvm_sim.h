@@ -0,0 +1,63 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Host stand-in for nvm_write, so flash traffic can be measured off-device.
+// MEMCPY_NV uses it in host builds. Data is copied like memcpy and every
+// write is accounted by the pages it touches: the device rewrites whole pages,
+// so a partial page costs as much as a full one.
+
+typedef struct {
+    const char *name;
+    uint16_t page_size;             // bytes
+    uint32_t page_write_us;         // erase + program one page
+    uint32_t call_overhead_us;      // per nvm_write call
+} nvm_sim_profile_t;
+
+// Approximate figures, to compare strategies rather than to predict exact timings
+extern const nvm_sim_profile_t nvm_sim_profile_nanos;
+extern const nvm_sim_profile_t nvm_sim_profile_nanox;
+
+typedef struct {
+    uint32_t calls;
+    uint32_t bytes_written;
+    uint32_t page_writes;           // pages touched, summed over calls
+    uint32_t partial_page_writes;   // pages that were only partly written by a call
+    uint64_t latency_us;            // modelled time spent writing
+} nvm_sim_stats_t;
+
+/// Selects the page size and latencies used for accounting (Nano S by default)
+void nvm_sim_set_profile(const nvm_sim_profile_t *profile);
+
+/// Clears the counters
+void nvm_sim_reset_stats();
+
+/// Counters since the last reset
+const nvm_sim_stats_t *nvm_sim_get_stats();
+
+/// Copies len bytes to dst and accounts the write
+void *nvm_sim_write(void *dst, const void *src, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -92,7 +92,9 @@ void __logstack();
 #define MEMSET memset
 #define MEMCPY memcpy
 #define MEMCMP memcmp
-#define MEMCPY_NV memcpy
+// Accounts flash writes, see nvm_sim.h
+#include "nvm_sim.h"
+#define MEMCPY_NV nvm_sim_write
 
 #ifndef __APPLE__
 #define MEMZERO explicit_bzero
@@ -103,6 +105,11 @@ __Z_INLINE void __memzero(void *buffer, size_t s) { memset(buffer, 0, s); }
 
 #define LOG(str)
 #define LOGSTACK()
+
+// os.h defines it on the device
+#ifndef UNUSED
+#define UNUSED(x) (void)x
+#endif
 #endif
 
 #include <inttypes.h>
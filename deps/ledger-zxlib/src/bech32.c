@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #include "bech32.h"
 #include "segwit_addr.h"
 #include "bittools.h"
@@ -35,3 +36,91 @@ void bech32EncodeFromBytes(char *output,
     convert_bits(tmp_data, &tmp_size, 5, data, data_len, 8, 0);
     bech32_encode(output, hrp, tmp_data, tmp_size);
 }
+
+// bech32 generator applied to each value of the top 5 bits of the checksum
+static const uint32_t bech32_polymod_table[32] = {
+        0x00000000, 0x3b6a57b2, 0x26508e6d, 0x1d3ad9df,
+        0x1ea119fa, 0x25cb4e48, 0x38f19797, 0x039bc025,
+        0x3d4233dd, 0x0628646f, 0x1b12bdb0, 0x2078ea02,
+        0x23e32a27, 0x18897d95, 0x05b3a44a, 0x3ed9f3f8,
+        0x2a1462b3, 0x117e3501, 0x0c44ecde, 0x372ebb6c,
+        0x34b57b49, 0x0fdf2cfb, 0x12e5f524, 0x298fa296,
+        0x1756516e, 0x2c3c06dc, 0x3106df03, 0x0a6c88b1,
+        0x09f74894, 0x329d1f26, 0x2fa7c6f9, 0x14cd914b,
+};
+
+static const char bech32_charset[32] = {
+        'q', 'p', 'z', 'r', 'y', '9', 'x', '8', 'g', 'f', '2', 't', 'v', 'd', 'w', '0',
+        's', '3', 'j', 'n', '5', '4', 'k', 'h', 'c', 'e', '6', 'm', 'u', 'a', '7', 'l',
+};
+
+#define BECH32_POLYMOD(chk, v) ((((chk) & 0x1FFFFFFu) << 5u) ^ bech32_polymod_table[(chk) >> 25u] ^ (v))
+
+uint32_t bech32HrpState(const char *hrp) {
+    const size_t hrpLen = strlen(hrp);
+    if (hrpLen == 0 || hrpLen > BECH32_BYTES32_MAX_HRP_LEN) {
+        return 0;
+    }
+
+    uint32_t chk = 1;
+    for (size_t i = 0; i < hrpLen; i++) {
+        const uint8_t ch = (uint8_t) hrp[i];
+        if (ch < 33 || ch > 126 || (ch >= 'A' && ch <= 'Z')) {
+            return 0;
+        }
+        chk = BECH32_POLYMOD(chk, ch >> 5u);
+    }
+    chk = BECH32_POLYMOD(chk, 0);
+    for (size_t i = 0; i < hrpLen; i++) {
+        chk = BECH32_POLYMOD(chk, (uint8_t) hrp[i] & 0x1Fu);
+    }
+    return chk;
+}
+
+void bech32EncodeFromBytes32(char *output,
+                             const char *hrp,
+                             uint32_t hrpState,
+                             const uint8_t data[32]) {
+    output[0] = 0;
+    const size_t hrpLen = strlen(hrp);
+    if (hrpState == 0 || hrpLen > BECH32_BYTES32_MAX_HRP_LEN) {
+        return;
+    }
+
+    memcpy(output, hrp, hrpLen);
+    char *out = output + hrpLen;
+    *out++ = '1';
+
+    uint32_t chk = hrpState;
+
+    // 5 bytes are 8 groups of 5 bits
+    for (uint8_t i = 0; i < 30; i += 5) {
+        const uint64_t v = ((uint64_t) data[i] << 32u) |
+                           ((uint32_t) data[i + 1] << 24u) |
+                           ((uint32_t) data[i + 2] << 16u) |
+                           ((uint32_t) data[i + 3] << 8u) |
+                           data[i + 4];
+        for (int8_t shift = 35; shift >= 0; shift -= 5) {
+            const uint8_t group = (uint8_t) (v >> (uint8_t) shift) & 0x1Fu;
+            chk = BECH32_POLYMOD(chk, group);
+            *out++ = bech32_charset[group];
+        }
+    }
+
+    // the last 2 bytes give 3 groups, like bech32EncodeFromBytes the leftover bit is not padded
+    const uint32_t tail = ((uint32_t) data[30] << 8u) | data[31];
+    for (int8_t shift = 11; shift >= 1; shift -= 5) {
+        const uint8_t group = (uint8_t) (tail >> (uint8_t) shift) & 0x1Fu;
+        chk = BECH32_POLYMOD(chk, group);
+        *out++ = bech32_charset[group];
+    }
+
+    for (uint8_t i = 0; i < 6; i++) {
+        chk = BECH32_POLYMOD(chk, 0);
+    }
+    chk ^= 1u;
+    for (int8_t shift = 25; shift >= 0; shift -= 5) {
+        *out++ = bech32_charset[(chk >> (uint8_t) shift) & 0x1Fu];
+    }
+    *out = 0;
+}
@@ -146,3 +146,290 @@ void bignumBigEndian_to_bcd(uint8_t *bcdOut, uint16_t bcdOutLen,
         }
     }
 }
+
+#define BIGNUM_CHUNK_DIV    1000000000u      // 10^9, the largest power of 10 that fits in 32 bits
+#define BIGNUM_CHUNK_DIGITS 9u
+
+static const uint32_t bignum_pow10[BIGNUM_CHUNK_DIGITS] = {
+        1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u
+};
+
+// Tier 1: up to 64 bits. Only the chunks above 32 bits need 64-bit divisions
+__Z_INLINE uint8_t bignum_chunksU64(uint32_t *chunks, uint8_t count, uint64_t value) {
+    while (value > UINT32_MAX) {
+        chunks[count++] = (uint32_t) (value % BIGNUM_CHUNK_DIV);
+        value /= BIGNUM_CHUNK_DIV;
+    }
+    // values between 10^9 and 2^32 still need two chunks
+    if (value >= BIGNUM_CHUNK_DIV) {
+        chunks[count++] = (uint32_t) value % BIGNUM_CHUNK_DIV;
+        value = (uint32_t) value / BIGNUM_CHUNK_DIV;
+    }
+    chunks[count++] = (uint32_t) value;
+    return count;
+}
+
+// Tier 2: up to 128 bits, as hi:lo. Each step divides by 10^9 until hi is zero
+__Z_INLINE uint8_t bignum_chunksU128(uint32_t *chunks, uint8_t count, uint64_t hi, uint64_t lo) {
+    while (hi != 0) {
+        uint64_t rem = hi % BIGNUM_CHUNK_DIV;
+        hi /= BIGNUM_CHUNK_DIV;
+
+        // rem < 2^30, so the partial dividends fit in 64 bits
+        uint64_t partial = (rem << 32u) | (lo >> 32u);
+        const uint64_t q1 = partial / BIGNUM_CHUNK_DIV;
+        rem = partial % BIGNUM_CHUNK_DIV;
+
+        partial = (rem << 32u) | (lo & UINT32_MAX);
+        const uint64_t q0 = partial / BIGNUM_CHUNK_DIV;
+        rem = partial % BIGNUM_CHUNK_DIV;
+
+        lo = (q1 << 32u) | q0;
+        chunks[count++] = (uint32_t) rem;
+    }
+    return bignum_chunksU64(chunks, count, lo);
+}
+
+// Tier 3: any size, as little endian 32-bit limbs. Each step divides by 10^9 until it fits in 128 bits
+__Z_INLINE uint8_t bignum_chunksLimbs(uint32_t *chunks, uint32_t *limbs, uint8_t limbsLen) {
+    uint8_t count = 0;
+    while (limbsLen > 4) {
+        uint64_t rem = 0;
+        for (uint8_t i = limbsLen; i > 0; i--) {
+            const uint64_t partial = (rem << 32u) | limbs[i - 1];
+            limbs[i - 1] = (uint32_t) (partial / BIGNUM_CHUNK_DIV);
+            rem = partial % BIGNUM_CHUNK_DIV;
+        }
+        if (limbs[limbsLen - 1] == 0) {
+            limbsLen--;
+        }
+        chunks[count++] = (uint32_t) rem;
+    }
+
+    const uint64_t hi = ((uint64_t) limbs[3] << 32u) | limbs[2];
+    const uint64_t lo = ((uint64_t) limbs[1] << 32u) | limbs[0];
+    return bignum_chunksU128(chunks, count, hi, lo);
+}
+
+__Z_INLINE uint64_t bignum_readU64(const uint8_t *binValue, uint16_t binValueLen) {
+    uint64_t value = 0;
+    for (uint16_t i = 0; i < binValueLen; i++) {
+        value = (value << 8u) | binValue[i];
+    }
+    return value;
+}
+
+uint8_t bignumBigEndian_to_chunks(uint32_t chunks[BIGNUM_MAX_CHUNKS],
+                                  const uint8_t *binValue, uint16_t binValueLen) {
+    // Leading zero bytes do not change the value, but they would select a slower tier
+    while (binValueLen > 0 && *binValue == 0) {
+        binValue++;
+        binValueLen--;
+    }
+
+    if (binValueLen <= 8) {
+        return bignum_chunksU64(chunks, 0, bignum_readU64(binValue, binValueLen));
+    }
+
+    if (binValueLen <= 16) {
+        const uint16_t loLen = 8;
+        const uint64_t hi = bignum_readU64(binValue, binValueLen - loLen);
+        const uint64_t lo = bignum_readU64(binValue + binValueLen - loLen, loLen);
+        return bignum_chunksU128(chunks, 0, hi, lo);
+    }
+
+    if (binValueLen > BIGNUM_MAX_BYTES) {
+        return 0;
+    }
+
+    uint32_t limbs[BIGNUM_MAX_BYTES / 4];
+    const uint8_t limbsLen = (uint8_t) ((binValueLen + 3u) / 4u);
+    for (uint8_t i = 0; i < limbsLen; i++) {
+        const uint16_t end = binValueLen - 4u * i;
+        const uint16_t len = end < 4 ? end : 4;
+        limbs[i] = (uint32_t) bignum_readU64(binValue + end - len, len);
+    }
+    return bignum_chunksLimbs(chunks, limbs, limbsLen);
+}
+
+__Z_INLINE uint16_t bignum_chunksDigits(const uint32_t *chunks, uint8_t chunksLen) {
+    uint16_t digits = BIGNUM_CHUNK_DIGITS * (chunksLen - 1u);
+    const uint32_t top = chunks[chunksLen - 1];
+    do {
+        digits++;
+    } while (digits % BIGNUM_CHUNK_DIGITS != 0 && top >= bignum_pow10[digits % BIGNUM_CHUNK_DIGITS]);
+    return digits;
+}
+
+bool_t bignumBigEndian_to_decimal(char *outBuffer, uint16_t outBufferLen,
+                                  const uint8_t *binValue, uint16_t binValueLen) {
+    MEMZERO(outBuffer, outBufferLen);
+
+    if (outBufferLen < 4) {
+        return bool_false;
+    }
+
+    uint32_t chunks[BIGNUM_MAX_CHUNKS];
+    const uint8_t chunksLen = bignumBigEndian_to_chunks(chunks, binValue, binValueLen);
+    const uint16_t digits = chunksLen == 0 ? 0 : bignum_chunksDigits(chunks, chunksLen);
+
+    if (chunksLen == 0 || digits >= outBufferLen) {
+        strcpy(outBuffer, "ERR");
+        return bool_false;
+    }
+
+    // Each chunk is written backwards from its least significant digit
+    char *cursor = outBuffer + digits;
+    for (uint8_t i = 0; i < chunksLen; i++) {
+        uint32_t chunk = chunks[i];
+        for (uint8_t j = 0; j < BIGNUM_CHUNK_DIGITS && cursor != outBuffer; j++) {
+            *--cursor = (char) ('0' + chunk % 10u);
+            chunk /= 10u;
+        }
+    }
+
+    return bool_true;
+}
+
+// Writes digits [from, to) of the value, 0 being the most significant one
+// Each chunk is expanded once, so a page window does not divide per character
+__Z_INLINE void bignum_putDigitRange(char *out, const uint32_t *chunks, uint16_t digits,
+                                     uint16_t from, uint16_t to) {
+    while (from < to) {
+        const uint16_t pos = digits - 1u - from;
+        const uint8_t top = (uint8_t) (pos % BIGNUM_CHUNK_DIGITS);
+
+        char expanded[BIGNUM_CHUNK_DIGITS];
+        uint32_t chunk = chunks[pos / BIGNUM_CHUNK_DIGITS];
+        for (uint8_t i = 0; i <= top; i++) {
+            expanded[i] = (char) ('0' + chunk % 10u);
+            chunk /= 10u;
+        }
+
+        uint16_t count = top + 1u;
+        if (count > to - from) {
+            count = to - from;
+        }
+        for (uint16_t i = 0; i < count; i++) {
+            *out++ = expanded[top - i];
+        }
+        from += count;
+    }
+}
+
+uint16_t bignumBigEndian_to_fpstr_len(const uint8_t *binValue, uint16_t binValueLen,
+                                      uint8_t decimals, uint16_t suffixLen) {
+    uint32_t chunks[BIGNUM_MAX_CHUNKS];
+    const uint8_t chunksLen = bignumBigEndian_to_chunks(chunks, binValue, binValueLen);
+    if (chunksLen == 0) {
+        return 0;
+    }
+    const uint16_t digits = bignum_chunksDigits(chunks, chunksLen);
+
+    // 0.000ddd or ddd.ddd, as in bignumBigEndian_to_fpstr_page
+    const uint16_t numberLen = digits <= decimals ? 2u + decimals : digits + 1u;
+    return numberLen + suffixLen;
+}
+
+typedef enum {
+    segment_char,
+    segment_zeros,
+    segment_digits,
+    segment_suffix,
+} bignum_segment_e;
+
+typedef struct {
+    bignum_segment_e kind;
+    uint16_t len;
+    uint16_t from;      // first digit, for segment_digits
+    char c;             // for segment_char
+} bignum_segment_t;
+
+bool_t bignumBigEndian_to_fpstr_page(char *outValue, uint16_t outValueLen,
+                                     const uint8_t *binValue, uint16_t binValueLen,
+                                     uint8_t decimals, const char *suffix,
+                                     uint8_t pageIdx, uint8_t *pageCount) {
+    uint32_t chunks[BIGNUM_MAX_CHUNKS];
+    const uint8_t chunksLen = bignumBigEndian_to_chunks(chunks, binValue, binValueLen);
+    MEMZERO(outValue, outValueLen);
+    if (chunksLen == 0) {
+        return bool_false;
+    }
+    const uint16_t digits = bignum_chunksDigits(chunks, chunksLen);
+    const uint16_t suffixLen = strlen(suffix);
+
+    // Same layout as fpstr_to_str followed by the suffix
+    bignum_segment_t segments[5];
+    uint8_t segmentsLen = 0;
+    if (digits <= decimals) {
+        // 0.000ddd
+        segments[segmentsLen++] = (bignum_segment_t) {segment_char, 1, 0, '0'};
+        segments[segmentsLen++] = (bignum_segment_t) {segment_char, 1, 0, '.'};
+        segments[segmentsLen++] = (bignum_segment_t) {segment_zeros, decimals - digits, 0, 0};
+        segments[segmentsLen++] = (bignum_segment_t) {segment_digits, digits, 0, 0};
+    } else {
+        // ddd.ddd
+        const uint16_t point = digits - decimals;
+        segments[segmentsLen++] = (bignum_segment_t) {segment_digits, point, 0, 0};
+        segments[segmentsLen++] = (bignum_segment_t) {segment_char, 1, 0, '.'};
+        segments[segmentsLen++] = (bignum_segment_t) {segment_digits, decimals, point, 0};
+    }
+    segments[segmentsLen++] = (bignum_segment_t) {segment_suffix, suffixLen, 0, 0};
+
+    uint16_t totalLen = 0;
+    for (uint8_t i = 0; i < segmentsLen; i++) {
+        totalLen += segments[i].len;
+    }
+
+    // Same paging as pageStringExt, writing only the requested page
+    outValueLen--;  // leave space for NULL termination
+    if (outValueLen == 0) {
+        return bool_true;
+    }
+
+    *pageCount = (uint8_t) (totalLen / outValueLen);
+    const uint16_t lastChunkLen = totalLen % outValueLen;
+    if (lastChunkLen > 0) {
+        (*pageCount)++;
+    }
+
+    if (pageIdx >= *pageCount) {
+        return bool_true;
+    }
+
+    const uint16_t pageStart = pageIdx * outValueLen;
+    const uint16_t pageEnd = pageStart +
+                             ((lastChunkLen > 0 && pageIdx == *pageCount - 1) ? lastChunkLen : outValueLen);
+
+    uint16_t segmentStart = 0;
+    for (uint8_t i = 0; i < segmentsLen && segmentStart < pageEnd; i++) {
+        const bignum_segment_t *segment = &segments[i];
+        const uint16_t segmentEnd = segmentStart + segment->len;
+
+        // part of the segment in the page
+        const uint16_t from = segmentStart > pageStart ? segmentStart : pageStart;
+        const uint16_t to = segmentEnd < pageEnd ? segmentEnd : pageEnd;
+        if (from < to) {
+            char *out = outValue + (from - pageStart);
+            const uint16_t offset = from - segmentStart;
+            const uint16_t count = to - from;
+            switch (segment->kind) {
+                case segment_char:
+                    *out = segment->c;
+                    break;
+                case segment_zeros:
+                    MEMSET(out, '0', count);
+                    break;
+                case segment_digits:
+                    bignum_putDigitRange(out, chunks, digits, segment->from + offset, segment->from + offset + count);
+                    break;
+                case segment_suffix:
+                    MEMCPY(out, suffix + offset, count);
+                    break;
+            }
+        }
+        segmentStart = segmentEnd;
+    }
+
+    return bool_true;
+}
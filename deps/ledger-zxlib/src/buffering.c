@@ -24,6 +24,13 @@ extern "C" {
 buffer_state_t ram;         // Ram
 buffer_state_t flash;       // Flash
 
+// Total length declared with buffering_reserve, 0 if unknown
+uint32_t declared_length;
+
+// Once flash is in use, the RAM buffer stages the last appended bytes so that
+// flash is written in whole pages. flash.pos counts them, flash has flash.pos - staged_len
+uint16_t staged_len;
+
 void buffering_init(uint8_t *ram_buffer,
                     uint16_t ram_buffer_size,
                     uint8_t *flash_buffer,
@@ -37,6 +44,9 @@ void buffering_init(uint8_t *ram_buffer,
     flash.size = flash_buffer_size;
     flash.pos = 0;
     flash.in_use = 0;
+
+    declared_length = 0;
+    staged_len = 0;
 }
 
 void buffering_reset() {
@@ -44,37 +54,124 @@ void buffering_reset() {
     ram.in_use = 1;
     flash.pos = 0;
     flash.in_use = 0;
+
+    declared_length = 0;
+    staged_len = 0;
+}
+
+int buffering_reserve(uint32_t total_length) {
+    if (ram.pos > 0 || flash.pos > 0 || total_length == 0) {
+        return 0;
+    }
+
+    if (total_length <= ram.size) {
+        ram.in_use = 1;
+        flash.in_use = 0;
+    } else if (total_length <= flash.size) {
+        // Too big for RAM, write to flash from the start
+        ram.in_use = 0;
+        flash.in_use = 1;
+    } else {
+        return 0;
+    }
+
+    declared_length = total_length;
+    return 1;
+}
+
+__Z_INLINE uint8_t buffering_can_stage() {
+    return ram.data != NULL && ram.size >= BUFFERING_FLASH_PAGE_SIZE;
+}
+
+// Writes the first len staged bytes to flash
+__Z_INLINE void buffering_commit(uint16_t len) {
+    const uint16_t committed = flash.pos - staged_len;
+    MEMCPY_NV(flash.data + committed, ram.data, len);
+    staged_len -= len;
+    if (staged_len > 0) {
+        MEMMOVE(ram.data, ram.data + len, staged_len);
+    }
+}
+
+__Z_INLINE int buffering_append_flash(uint8_t *data, int length) {
+    if (flash.size - flash.pos < length) {
+        return 0;
+    }
+
+    if (!buffering_can_stage()) {
+        MEMCPY_NV(flash.data + flash.pos, data, length);
+        flash.pos += length;
+        return length;
+    }
+
+    int remaining = length;
+    while (remaining > 0) {
+        if (staged_len == ram.size) {
+            // Staging is full, write all the whole pages it holds at once
+            buffering_commit(staged_len - staged_len % BUFFERING_FLASH_PAGE_SIZE);
+        }
+
+        uint16_t n = ram.size - staged_len;
+        if (n > remaining) {
+            n = remaining;
+        }
+        MEMCPY(ram.data + staged_len, data, n);
+        staged_len += n;
+        flash.pos += n;
+        data += n;
+        remaining -= n;
+    }
+
+    return length;
 }
 
 int buffering_append(uint8_t *data, int length) {
+    if (declared_length > 0) {
+        const buffer_state_t *current = ram.in_use ? &ram : &flash;
+        if (length < 0 || current->pos + (uint32_t) length > declared_length) {
+            return 0;
+        }
+    }
+
     if (ram.in_use) {
         if (ram.size - ram.pos >= length) {
             // RAM in use, append to ram if there is enough space
             MEMCPY(ram.data + ram.pos, data, length);
             ram.pos += length;
         } else {
-            // If RAM is not big enough copy memory to flash
+            // If RAM is not big enough continue in flash
             ram.in_use = 0;
             flash.in_use = 1;
-            if (ram.pos > 0) {
-                buffering_append(ram.data, ram.pos);
+            if (buffering_can_stage()) {
+                // RAM data is already where flash data is staged, it is written with the next pages
+                staged_len = ram.pos;
+                flash.pos = ram.pos;
+            } else if (ram.pos > 0) {
+                buffering_append_flash(ram.data, ram.pos);
             }
-            int num_bytes = buffering_append(data, length);
             ram.pos = 0;
-            return num_bytes;
+            return buffering_append_flash(data, length);
         }
     } else {
         // Flash in use, append to flash
-        if (flash.size - flash.pos >= length) {
-            MEMCPY_NV(flash.data + flash.pos, data, length);
-            flash.pos += length;
-        } else {
-            return 0;
-        }
+        return buffering_append_flash(data, length);
     }
     return length;
 }
 
+void buffering_flush() {
+    if (flash.in_use && staged_len > 0) {
+        buffering_commit(staged_len);
+    }
+}
+
+uint16_t buffering_get_committed_length() {
+    if (ram.in_use) {
+        return ram.pos;
+    }
+    return flash.pos - staged_len;
+}
+
 buffer_state_t *buffering_get_ram_buffer() {
     return &ram;
 }
@@ -0,0 +1,82 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#if !defined(TARGET_NANOS) && !defined(TARGET_NANOX)
+
+#include <string.h>
+#include "nvm_sim.h"
+
+const nvm_sim_profile_t nvm_sim_profile_nanos = {
+        .name = "nanos",
+        .page_size = 64,
+        .page_write_us = 2000,
+        .call_overhead_us = 50,
+};
+
+const nvm_sim_profile_t nvm_sim_profile_nanox = {
+        .name = "nanox",
+        .page_size = 512,
+        .page_write_us = 4000,
+        .call_overhead_us = 50,
+};
+
+static const nvm_sim_profile_t *nvm_sim_profile = &nvm_sim_profile_nanos;
+static nvm_sim_stats_t nvm_sim_stats;
+
+void nvm_sim_set_profile(const nvm_sim_profile_t *profile) {
+    nvm_sim_profile = profile;
+}
+
+void nvm_sim_reset_stats() {
+    memset(&nvm_sim_stats, 0, sizeof(nvm_sim_stats));
+}
+
+const nvm_sim_stats_t *nvm_sim_get_stats() {
+    return &nvm_sim_stats;
+}
+
+void *nvm_sim_write(void *dst, const void *src, size_t len) {
+    memcpy(dst, src, len);
+    if (len == 0) {
+        return dst;
+    }
+
+    // Pages are aligned on absolute addresses, as flash is
+    const uintptr_t pageSize = nvm_sim_profile->page_size;
+    const uintptr_t start = (uintptr_t) dst;
+    const uintptr_t end = start + len;
+    const uintptr_t firstPage = start / pageSize;
+    const uintptr_t lastPage = (end - 1) / pageSize;
+    const uint32_t pages = (uint32_t) (lastPage - firstPage + 1);
+
+    uint32_t partial = 0;
+    if (start % pageSize != 0) {
+        partial++;
+    }
+    if (end % pageSize != 0 && (lastPage != firstPage || partial == 0)) {
+        partial++;
+    }
+
+    nvm_sim_stats.calls++;
+    nvm_sim_stats.bytes_written += (uint32_t) len;
+    nvm_sim_stats.page_writes += pages;
+    nvm_sim_stats.partial_page_writes += partial;
+    nvm_sim_stats.latency_us += nvm_sim_profile->call_overhead_us +
+                                (uint64_t) pages * nvm_sim_profile->page_write_us;
+    return dst;
+}
+
+#endif
@@ -16,6 +16,8 @@
 #include <gmock/gmock.h>
 #include <zxmacros.h>
 #include <bech32.h>
+#include <random>
+#include <string>
 
 namespace {
     TEST(BECH32, hex_to_address) {
@@ -33,4 +35,68 @@ namespace {
         std::cout << addr_out << std::endl;
         ASSERT_STREQ("zx1qyps2pcfpvx20dk22", addr_out);
     }
+
+    std::string encodeReference(const char *hrp, const uint8_t *data) {
+        char addr_out[100];
+        bech32EncodeFromBytes(addr_out, hrp, data, 32);
+        return addr_out;
+    }
+
+    std::string encode32(const char *hrp, const uint8_t *data) {
+        char addr_out[100];
+        MEMSET(addr_out, 'X', sizeof(addr_out));
+        bech32EncodeFromBytes32(addr_out, hrp, bech32HrpState(hrp), data);
+        EXPECT_EQ(strlen(addr_out), BECH32_BYTES32_ADDR_LEN(strlen(hrp)));
+        return addr_out;
+    }
+
+    TEST(BECH32, bytes32_edges) {
+        uint8_t data[32];
+        const char *hrps[] = {"oasis", "zx", "a", "cosmos", "abcdefghijklmnopqrstuvwxyzabcdef"};
+
+        for (const char *hrp : hrps) {
+            for (uint8_t fill : {0x00, 0xFF, 0x55, 0xAA, 0x01, 0x80}) {
+                MEMSET(data, fill, sizeof(data));
+                ASSERT_EQ(encode32(hrp, data), encodeReference(hrp, data)) << hrp << " " << (int) fill;
+            }
+        }
+    }
+
+    TEST(BECH32, bytes32_single_bits) {
+        uint8_t data[32];
+        for (int bit = 0; bit < 256; bit++) {
+            MEMZERO(data, sizeof(data));
+            data[bit / 8] = 0x80u >> (bit % 8);
+            ASSERT_EQ(encode32("oasis", data), encodeReference("oasis", data)) << bit;
+        }
+    }
+
+    TEST(BECH32, bytes32_random) {
+        std::mt19937 gen(1234);
+        std::uniform_int_distribution<int> byte(0, 255);
+        uint8_t data[32];
+
+        for (int i = 0; i < 2000; i++) {
+            for (auto &b : data) {
+                b = (uint8_t) byte(gen);
+            }
+            ASSERT_EQ(encode32("oasis", data), encodeReference("oasis", data)) << i;
+        }
+    }
+
+    TEST(BECH32, bytes32_invalid_hrp) {
+        char addr_out[100];
+        uint8_t data[32] = {0};
+
+        EXPECT_EQ(bech32HrpState(""), 0u);
+        EXPECT_EQ(bech32HrpState("Oasis"), 0u);
+        EXPECT_EQ(bech32HrpState("oa sis"), 0u);
+        // 32 is the longest that keeps the address within 90 characters
+        EXPECT_NE(bech32HrpState("abcdefghijklmnopqrstuvwxyzabcdef"), 0u);
+        EXPECT_EQ(bech32HrpState("abcdefghijklmnopqrstuvwxyzabcdefg"), 0u);
+
+        MEMSET(addr_out, 'X', sizeof(addr_out));
+        bech32EncodeFromBytes32(addr_out, "Oasis", bech32HrpState("Oasis"), data);
+        EXPECT_STREQ(addr_out, "");
+    }
 }
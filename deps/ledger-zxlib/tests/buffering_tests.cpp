@@ -16,6 +16,8 @@
 
 #include "gtest/gtest.h"
 #include "buffering.h"
+#include <cstring>
+#include <vector>
 
 namespace {
 
@@ -138,6 +140,8 @@ namespace {
         EXPECT_EQ(sizeof(small2), num_bytes) << "Append should not return error";
 
         // In this test we want to make sure that data is not compromised.
+        // The last bytes are staged in RAM until they are flushed
+        buffering_flush();
         uint8_t *dst = buffering_get_flash_buffer()->data;
         for (int i = 0; i < sizeof(small1) + sizeof(small2); i++) {
             if (i < sizeof(small1)) {
@@ -225,4 +229,131 @@ namespace {
         auto num_bytes = buffering_append(big, sizeof(big));
         EXPECT_EQ(0, num_bytes) << "Appending outside the bounds of the buffer should return error";
     }
+
+    TEST(Buffering, ReserveRam) {
+        uint8_t ram_buffer[100];
+        uint8_t flash_buffer[1000];
+
+        buffering_init(ram_buffer, sizeof(ram_buffer), flash_buffer, sizeof(flash_buffer));
+        EXPECT_EQ(1, buffering_reserve(100)) << "Declared length fits in RAM";
+
+        uint8_t small[40];
+        EXPECT_EQ(40, buffering_append(small, sizeof(small)));
+        EXPECT_EQ(40, buffering_append(small, sizeof(small)));
+        EXPECT_EQ(0, buffering_append(small, sizeof(small))) << "Appending beyond the declared length should fail";
+
+        EXPECT_TRUE(buffering_get_ram_buffer()->in_use);
+        EXPECT_FALSE(buffering_get_flash_buffer()->in_use);
+        EXPECT_EQ(80, buffering_get_ram_buffer()->pos);
+    }
+
+    TEST(Buffering, ReserveFlash) {
+        uint8_t ram_buffer[100];
+        uint8_t flash_buffer[1000];
+
+        buffering_init(ram_buffer, sizeof(ram_buffer), flash_buffer, sizeof(flash_buffer));
+        EXPECT_EQ(1, buffering_reserve(500)) << "Declared length fits in flash";
+
+        // Small chunks go to flash directly, nothing is moved later
+        EXPECT_FALSE(buffering_get_ram_buffer()->in_use);
+        EXPECT_TRUE(buffering_get_flash_buffer()->in_use);
+
+        uint8_t small[50];
+        for (int i = 0; i < 10; i++) {
+            EXPECT_EQ(50, buffering_append(small, sizeof(small)));
+            EXPECT_EQ(0, buffering_get_ram_buffer()->pos);
+        }
+        EXPECT_EQ(500, buffering_get_flash_buffer()->pos);
+        EXPECT_EQ(0, buffering_append(small, 1)) << "Appending beyond the declared length should fail";
+    }
+
+    TEST(Buffering, ReserveRejected) {
+        uint8_t ram_buffer[100];
+        uint8_t flash_buffer[1000];
+
+        buffering_init(ram_buffer, sizeof(ram_buffer), flash_buffer, sizeof(flash_buffer));
+        EXPECT_EQ(0, buffering_reserve(1001)) << "Declared length does not fit";
+        EXPECT_EQ(0, buffering_reserve(0));
+
+        // After appending, the buffer cannot be chosen again
+        uint8_t small[10];
+        EXPECT_EQ(10, buffering_append(small, sizeof(small)));
+        EXPECT_EQ(0, buffering_reserve(20));
+
+        // Reset forgets the declared length
+        buffering_reset();
+        EXPECT_EQ(1, buffering_reserve(20));
+        EXPECT_EQ(10, buffering_append(small, sizeof(small)));
+        EXPECT_EQ(10, buffering_append(small, sizeof(small)));
+        EXPECT_EQ(0, buffering_append(small, sizeof(small)));
+        buffering_reset();
+        uint8_t big[500];
+        EXPECT_EQ(500, buffering_append(big, sizeof(big))) << "Without a declared length data can move to flash";
+    }
+
+    // Appends chunks of the given sizes and checks that flash is only written in whole pages
+    void checkStaged(uint16_t ramSize, const std::vector<uint16_t> &chunks, bool reserve) {
+        std::vector<uint8_t> ram_buffer(ramSize);
+        std::vector<uint8_t> flash_buffer(2000, 0xEE);
+        buffering_init(ram_buffer.data(), ramSize, flash_buffer.data(), flash_buffer.size());
+
+        std::vector<uint8_t> expected;
+        for (uint16_t len : chunks) {
+            for (uint16_t i = 0; i < len; i++) {
+                expected.push_back((uint8_t) (expected.size() * 7 + 3));
+            }
+        }
+        if (reserve) {
+            ASSERT_EQ(1, buffering_reserve(expected.size()));
+        }
+
+        uint16_t offset = 0;
+        for (uint16_t len : chunks) {
+            ASSERT_EQ(len, buffering_append(expected.data() + offset, len));
+            offset += len;
+            ASSERT_EQ(offset, buffering_get_buffer()->pos);
+
+            const uint16_t committed = buffering_get_committed_length();
+            ASSERT_LE(committed, offset);
+            ASSERT_EQ(0, memcmp(buffering_get_buffer()->data, expected.data(), committed));
+            if (buffering_get_flash_buffer()->in_use) {
+                ASSERT_EQ(0, committed % BUFFERING_FLASH_PAGE_SIZE) << "Flash should be written in whole pages";
+                ASSERT_EQ(0xEE, flash_buffer[committed]) << "Nothing should be written after the last page";
+            }
+        }
+
+        buffering_flush();
+        ASSERT_EQ(expected.size(), buffering_get_committed_length());
+        ASSERT_EQ(0, memcmp(buffering_get_buffer()->data, expected.data(), expected.size()));
+    }
+
+    TEST(Buffering, StagedFlashWrites) {
+        // APDU sized chunks, moving from RAM to flash
+        checkStaged(384, {250, 250, 250, 250, 250, 13}, false);
+        checkStaged(384, {250, 250, 250, 250, 250, 13}, true);
+        // RAM not a multiple of the page size
+        checkStaged(100, {30, 30, 30, 30, 30, 30, 30, 1}, false);
+        checkStaged(100, {99, 1, 255, 64, 64, 3}, false);
+        // Chunks bigger than the RAM buffer
+        checkStaged(128, {500, 7, 900}, false);
+        // Everything fits in RAM, nothing is staged
+        checkStaged(384, {100, 100}, false);
+    }
+
+    TEST(Buffering, StagedFlashReset) {
+        uint8_t ram_buffer[128];
+        uint8_t flash_buffer[1000];
+        buffering_init(ram_buffer, sizeof(ram_buffer), flash_buffer, sizeof(flash_buffer));
+
+        uint8_t big[300];
+        memset(big, 1, sizeof(big));
+        EXPECT_EQ(300, buffering_append(big, sizeof(big)));
+        EXPECT_LT(buffering_get_committed_length(), 300);
+
+        // Staged bytes are dropped
+        buffering_reset();
+        buffering_flush();
+        EXPECT_EQ(0, buffering_get_committed_length());
+        EXPECT_EQ(0, buffering_get_buffer()->pos);
+    }
 }
@@ -162,3 +162,184 @@ TEST(BignumBigEndianTests, range) {
         EXPECT_THAT(std::string(bufferUI), testing::Eq(expected.str())) << s.str();
     }
 }
+
+// Check that the decimal formatter matches the double dabble output
+TEST_P(BignumBigEndianTests, decimal) {
+    auto testcase = GetParam();
+
+    uint8_t inBuffer[100];
+    auto inBufferLen = parseHexString(testcase.hex.c_str(), inBuffer);
+
+    char bufferUI[300];
+    EXPECT_TRUE(bignumBigEndian_to_decimal(bufferUI, sizeof(bufferUI), inBuffer, inBufferLen));
+    EXPECT_THAT(std::string(bufferUI), testing::Eq(testcase.expectedOutput));
+}
+
+namespace {
+    // Formats with double dabble and with the decimal formatter, as the app does (80 bcd bytes, 160 chars)
+    void expectSameOutput(const uint8_t *inBuffer, uint16_t inBufferLen) {
+        uint8_t bcdOut[80];
+        char expected[160];
+        bignumBigEndian_to_bcd(bcdOut, sizeof(bcdOut), inBuffer, inBufferLen);
+        const bool_t expectedOk = bignumBigEndian_bcdprint(expected, sizeof(expected), bcdOut, sizeof(bcdOut));
+
+        char output[160];
+        const bool_t ok = bignumBigEndian_to_decimal(output, sizeof(output), inBuffer, inBufferLen);
+
+        EXPECT_EQ(expectedOk, ok);
+        EXPECT_EQ(0, memcmp(expected, output, sizeof(output)))
+                        << std::string(expected) << " != " << std::string(output);
+    }
+}
+
+TEST(BignumBigEndianTests, decimalRandom) {
+    uint8_t inBuffer[BIGNUM_MAX_BYTES];
+    uint32_t seed = 1;
+
+    for (uint16_t len = 0; len <= BIGNUM_MAX_BYTES; len++) {
+        for (int i = 0; i < 50; i++) {
+            for (uint16_t j = 0; j < len; j++) {
+                seed = seed * 1103515245u + 12345u;
+                inBuffer[j] = (uint8_t) (seed >> 16u);
+            }
+            // some values with leading zero bytes
+            if (i % 5 == 0 && len > 0) {
+                MEMZERO(inBuffer, (uint16_t) (i % len));
+            }
+            expectSameOutput(inBuffer, len);
+        }
+    }
+}
+
+TEST(BignumBigEndianTests, decimalTierBoundaries) {
+    uint8_t inBuffer[BIGNUM_MAX_BYTES];
+
+    for (uint16_t len = 1; len <= BIGNUM_MAX_BYTES; len++) {
+        // 2^(8*len) - 1
+        memset(inBuffer, 0xFF, len);
+        expectSameOutput(inBuffer, len);
+
+        // 2^(8*(len-1))
+        MEMZERO(inBuffer, len);
+        inBuffer[0] = 1;
+        expectSameOutput(inBuffer, len);
+
+        // 2^(8*len) - 2^32, so the low limb is zero
+        memset(inBuffer, 0xFF, len);
+        MEMZERO(inBuffer + len - (len < 4 ? len : 4), len < 4 ? len : 4);
+        expectSameOutput(inBuffer, len);
+    }
+}
+
+TEST(BignumBigEndianTests, decimalPowersOfTen) {
+    // 10^k - 1, 10^k and 10^k + 1 cover the chunk boundaries of the 10^9 divisions
+    for (uint16_t k = 1; k <= 154; k++) {
+        uint8_t value[BIGNUM_MAX_BYTES];
+        MEMZERO(value, sizeof(value));
+        value[sizeof(value) - 1] = 1;
+        for (uint16_t i = 0; i < k; i++) {
+            uint16_t carry = 0;
+            for (uint16_t j = sizeof(value); j > 0; j--) {
+                const uint16_t v = value[j - 1] * 10u + carry;
+                value[j - 1] = (uint8_t) v;
+                carry = v >> 8u;
+            }
+        }
+
+        std::string expected = "1" + std::string(k, '0');
+        char output[160];
+        EXPECT_TRUE(bignumBigEndian_to_decimal(output, sizeof(output), value, sizeof(value)));
+        EXPECT_THAT(std::string(output), testing::Eq(expected));
+
+        for (int delta : {-1, 1}) {
+            uint8_t adjusted[BIGNUM_MAX_BYTES];
+            memcpy(adjusted, value, sizeof(value));
+            for (uint16_t j = sizeof(adjusted); j > 0; j--) {
+                const uint8_t before = adjusted[j - 1];
+                adjusted[j - 1] = (uint8_t) (before + delta);
+                if ((delta > 0 && adjusted[j - 1] != 0) || (delta < 0 && before != 0)) {
+                    break;
+                }
+            }
+            expectSameOutput(adjusted, sizeof(adjusted));
+        }
+    }
+}
+
+TEST(BignumBigEndianTests, decimalSmallBuffer) {
+    const uint8_t inBuffer[] = {0x49, 0x96, 0x02, 0xD2};     // 1234567890
+
+    char output[11];
+    EXPECT_TRUE(bignumBigEndian_to_decimal(output, sizeof(output), inBuffer, sizeof(inBuffer)));
+    EXPECT_THAT(std::string(output), testing::Eq("1234567890"));
+
+    char shortOutput[10];
+    EXPECT_FALSE(bignumBigEndian_to_decimal(shortOutput, sizeof(shortOutput), inBuffer, sizeof(inBuffer)));
+    EXPECT_THAT(std::string(shortOutput), testing::Eq("ERR"));
+
+    char tooSmall[3];
+    EXPECT_FALSE(bignumBigEndian_to_decimal(tooSmall, sizeof(tooSmall), inBuffer, sizeof(inBuffer)));
+
+    uint8_t tooBig[BIGNUM_MAX_BYTES + 1];
+    memset(tooBig, 0xFF, sizeof(tooBig));
+    char bigOutput[300];
+    EXPECT_FALSE(bignumBigEndian_to_decimal(bigOutput, sizeof(bigOutput), tooBig, sizeof(tooBig)));
+}
+
+namespace {
+    // Formats the whole string as the parser used to, then pages it
+    void expectSamePages(const uint8_t *inBuffer, uint16_t inBufferLen,
+                         uint8_t decimals, const char *suffix, uint16_t outValueLen) {
+        char bignum[160];
+        char full[200];
+        ASSERT_TRUE(bignumBigEndian_to_decimal(bignum, sizeof(bignum), inBuffer, inBufferLen));
+        MEMZERO(full, sizeof(full));
+        fpstr_to_str(full, bignum, decimals);
+        strcat(full, suffix);
+        EXPECT_EQ(bignumBigEndian_to_fpstr_len(inBuffer, inBufferLen, decimals, strlen(suffix)), strlen(full));
+
+        uint8_t expectedPageCount = 1;
+        for (uint8_t pageIdx = 0; pageIdx <= expectedPageCount; pageIdx++) {
+            char expected[100];
+            char output[100];
+            uint8_t pageCount = 0xAA;
+            expectedPageCount = 0xAA;
+
+            pageStringExt(expected, outValueLen, full, strlen(full), pageIdx, &expectedPageCount);
+            EXPECT_TRUE(bignumBigEndian_to_fpstr_page(output, outValueLen, inBuffer, inBufferLen,
+                                                      decimals, suffix, pageIdx, &pageCount));
+
+            EXPECT_EQ(expectedPageCount, pageCount);
+            EXPECT_EQ(0, memcmp(expected, output, outValueLen))
+                            << full << " page " << (int) pageIdx << " width " << outValueLen;
+            if (expectedPageCount == 0xAA) {
+                break;
+            }
+        }
+    }
+}
+
+TEST(BignumBigEndianTests, fpstrPages) {
+    uint8_t inBuffer[BIGNUM_MAX_BYTES];
+    uint32_t seed = 7;
+
+    for (uint16_t len : {0, 1, 2, 4, 8, 9, 16, 17, 32, 64}) {
+        for (int i = 0; i < 10; i++) {
+            for (uint16_t j = 0; j < len; j++) {
+                seed = seed * 1103515245u + 12345u;
+                inBuffer[j] = (uint8_t) (seed >> 16u);
+            }
+            // short values to get leading zeros after the decimal point
+            if (i % 3 == 0 && len > 1) {
+                MEMZERO(inBuffer, len - 1);
+            }
+            for (uint8_t decimals : {0, 3, 9, 20}) {
+                for (const char *suffix : {"", "%"}) {
+                    for (uint16_t outValueLen : {1, 2, 5, 17, 19, 40, 100}) {
+                        expectSamePages(inBuffer, len, decimals, suffix, outValueLen);
+                    }
+                }
+            }
+        }
+    }
+}
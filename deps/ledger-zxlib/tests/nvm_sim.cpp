@@ -0,0 +1,80 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gtest/gtest.h>
+#include <zxmacros.h>
+#include "nvm_sim.h"
+#include "buffering.h"
+
+namespace {
+    TEST(NvmSim, pageAccounting) {
+        alignas(64) uint8_t flash[256];
+        uint8_t data[256] = {0};
+
+        nvm_sim_set_profile(&nvm_sim_profile_nanos);
+        nvm_sim_reset_stats();
+
+        // One whole page
+        MEMCPY_NV(flash, data, 64);
+        EXPECT_EQ(nvm_sim_get_stats()->page_writes, 1u);
+        EXPECT_EQ(nvm_sim_get_stats()->partial_page_writes, 0u);
+
+        // Inside a page
+        MEMCPY_NV(flash + 70, data, 10);
+        EXPECT_EQ(nvm_sim_get_stats()->page_writes, 2u);
+        EXPECT_EQ(nvm_sim_get_stats()->partial_page_writes, 1u);
+
+        // Across 3 pages, both ends partial
+        MEMCPY_NV(flash + 60, data, 80);
+        EXPECT_EQ(nvm_sim_get_stats()->page_writes, 5u);
+        EXPECT_EQ(nvm_sim_get_stats()->partial_page_writes, 3u);
+
+        EXPECT_EQ(nvm_sim_get_stats()->calls, 3u);
+        EXPECT_EQ(nvm_sim_get_stats()->bytes_written, 154u);
+        EXPECT_EQ(nvm_sim_get_stats()->latency_us,
+                  3u * nvm_sim_profile_nanos.call_overhead_us + 5u * nvm_sim_profile_nanos.page_write_us);
+
+        nvm_sim_reset_stats();
+        EXPECT_EQ(nvm_sim_get_stats()->calls, 0u);
+
+        // Bigger pages
+        nvm_sim_set_profile(&nvm_sim_profile_nanox);
+        alignas(512) static uint8_t flashX[1024];
+        MEMCPY_NV(flashX + 500, data, 100);
+        EXPECT_EQ(nvm_sim_get_stats()->page_writes, 2u);
+        EXPECT_EQ(nvm_sim_get_stats()->partial_page_writes, 2u);
+        nvm_sim_set_profile(&nvm_sim_profile_nanos);
+    }
+
+    TEST(NvmSim, bufferingWritesWholePages) {
+        uint8_t ram_buffer[384];
+        alignas(64) static uint8_t flash_buffer[8192];
+        uint8_t chunk[250] = {0};
+
+        nvm_sim_set_profile(&nvm_sim_profile_nanos);
+        buffering_init(ram_buffer, sizeof(ram_buffer), flash_buffer, sizeof(flash_buffer));
+        nvm_sim_reset_stats();
+
+        for (int i = 0; i < 16; i++) {
+            ASSERT_EQ(250, buffering_append(chunk, sizeof(chunk)));
+        }
+        EXPECT_EQ(nvm_sim_get_stats()->partial_page_writes, 0u) << "Only whole pages before the flush";
+
+        buffering_flush();
+        EXPECT_EQ(nvm_sim_get_stats()->bytes_written, 16u * 250u);
+        EXPECT_EQ(nvm_sim_get_stats()->page_writes, (16u * 250u + 63u) / 64u) << "Each page is written once";
+        EXPECT_LE(nvm_sim_get_stats()->partial_page_writes, 1u);
+    }
+}
@@ -491,6 +491,7 @@ CBOR_INLINE_API CborError cbor_value_get_map_length(const CborValue *value, size
 }
 
 CBOR_API CborError cbor_value_map_find_value(const CborValue *map, const char *string, CborValue *element);
+CBOR_API CborError cbor_value_map_seek_key(CborValue *element, const char *string, size_t len, bool *found);
 
 /* Floating point */
 CBOR_INLINE_API bool cbor_value_is_half_float(const CborValue *value)
@@ -565,6 +566,7 @@ enum CborValidationFlags {
 };
 
 CBOR_API CborError cbor_value_validate(const CborValue *it, uint32_t flags);
+CBOR_API CborError cbor_value_validate_shallow(const CborValue *it, uint32_t flags);
 
 /* Human-readable (dump) API */
 
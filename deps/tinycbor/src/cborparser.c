@@ -1371,6 +1371,114 @@ error:
     return err;
 }
 
+static size_t encoded_string_header_size(uint64_t len)
+{
+    if (len < Value8Bit)
+        return 1;
+    if (len <= 0xffU)
+        return 2;
+    if (len <= 0xffffU)
+        return 3;
+    if (len <= 0xffffffffU)
+        return 5;
+    return 9;
+}
+
+/* Compares the text string key \a it points to against \a string using the
+ * canonical key order (shorter encoding first, then bytewise). Returns a
+ * negative value, zero or a positive value if the key sorts before, equal to
+ * or after \a string. */
+static CborError compare_canonical_key(const CborValue *it, const char *string, size_t len, int *cmp)
+{
+    uint64_t keyLen = _cbor_value_extract_int64_helper(it);
+    uint8_t descriptor = *it->ptr & SmallValueMask;
+    size_t keyHeader = descriptor < Value8Bit ? 1 : 1 + (1 << (descriptor - Value8Bit));
+    size_t header = encoded_string_header_size(len);
+
+    if (keyLen > (uint64_t)(it->parser->end - it->ptr) - keyHeader)
+        return CborErrorUnexpectedEOF;
+
+    if (keyHeader + keyLen != header + len) {
+        *cmp = keyHeader + keyLen < header + len ? -1 : 1;
+        return CborNoError;
+    }
+
+    if (keyHeader != header) {
+        /* same encoded size, so the first byte differs (non-shortest length) */
+        *cmp = keyHeader < header ? -1 : 1;
+        return CborNoError;
+    }
+
+    *cmp = memcmp(it->ptr + keyHeader, string, len);
+    return CborNoError;
+}
+
+/**
+ * Moves the map iterator \a element forward to the entry whose key is the
+ * text string \a string of length \a len. \a element must point to a key
+ * (or to the end) of a map whose keys are sorted in canonical order, as
+ * described in RFC 7049 section 3.9.
+ *
+ * Entries whose key sorts before \a string are skipped. If the key is found,
+ * \a element is left pointing to its value and \a found is set to true.
+ * Otherwise \a element is left pointing to the first key that sorts after
+ * \a string, or to the end of the map, and \a found is set to false, so the
+ * next lookup resumes from there. A missing key is usually detected with a
+ * single length comparison.
+ *
+ * Keys are compared in their encoded form, without iterating over string
+ * chunks. Keys that are not definite-length text strings, or that are tagged,
+ * never match and are skipped.
+ *
+ * Reading all the entries of a map in canonical order with this function is a
+ * single linear pass, unlike cbor_value_map_find_value() which restarts from
+ * the first key on every call.
+ *
+ * \sa cbor_value_map_find_value(), cbor_value_advance()
+ */
+CborError cbor_value_map_seek_key(CborValue *element, const char *string, size_t len, bool *found)
+{
+    CborError err;
+    *found = false;
+
+    while (!cbor_value_at_end(element)) {
+        int cmp = -1;
+        if (cbor_value_is_tag(element)) {
+            /* tagged keys never match, skip the tags so the whole key is skipped */
+            err = cbor_value_skip_tag(element);
+            if (err)
+                return err;
+        } else if (cbor_value_is_text_string(element) && cbor_value_is_length_known(element)) {
+            err = compare_canonical_key(element, string, len, &cmp);
+            if (err)
+                return err;
+        }
+
+        if (cmp > 0)
+            return CborNoError;
+
+        /* skip the key */
+        err = cbor_value_advance(element);
+        if (err)
+            return err;
+
+        if (cmp == 0) {
+            *found = true;
+            return CborNoError;
+        }
+
+        /* skip this value */
+        err = cbor_value_skip_tag(element);
+        if (err)
+            return err;
+        err = cbor_value_advance(element);
+        if (err)
+            return err;
+    }
+
+    return CborNoError;
+}
+
 /**
  * \fn bool cbor_value_is_float(const CborValue *value)
  *
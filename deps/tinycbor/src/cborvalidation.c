@@ -272,7 +272,12 @@ static inline CborError validate_utf8_string(const void *ptr, size_t n)
     const uint8_t *buffer = (const uint8_t *)ptr;
     const uint8_t * const end = buffer + n;
     while (buffer < end) {
-        uint32_t uc = get_utf8(&buffer, end);
+        uint32_t uc;
+        /* text is mostly ASCII: decode only from the block that has a high bit */
+        buffer = skip_ascii(buffer, end);
+        if (buffer == end)
+            break;
+        uc = get_utf8(&buffer, end);
         if (uc == ~0U)
             return CborErrorInvalidUtf8TextString;
     }
@@ -437,11 +442,65 @@ static inline CborError validate_floating_point(CborValue *it, CborType type, ui
 }
 #endif
 
+/* the value in the key's header: the length of a string key */
+static inline uint64_t map_key_length(const uint8_t *key, const uint8_t *end)
+{
+    uint64_t len = *key & SmallValueMask;
+    if (len >= Value8Bit)
+        _cbor_value_extract_number(&key, end, &len);
+    return len;
+}
+
+/* text string whose length fits in the initial byte */
+static inline int map_key_is_short_text(uint8_t initial)
+{
+    return (initial >> MajorTypeShift) == TextStringType && (initial & SmallValueMask) < Value8Bit;
+}
+
+/* the words compare like their bytes once read in big endian */
+static inline int map_key_compare_word(const uint8_t *p1, const uint8_t *p2)
+{
+    cbor_word w1, w2;
+    memcpy(&w1, p1, sizeof(w1));
+    memcpy(&w2, p2, sizeof(w2));
+    if (w1 == w2)
+        return 0;
+    return cbor_ntohw(w1) < cbor_ntohw(w2) ? -1 : 1;
+}
+
+/* memcmp, a word at a time */
+static inline int map_key_compare(const uint8_t *p1, const uint8_t *p2, size_t len)
+{
+    size_t i;
+    int r;
+
+    if (len < sizeof(cbor_word)) {
+        for (i = 0; i < len; ++i) {
+            if (p1[i] != p2[i])
+                return p1[i] < p2[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    for (i = 0; i + sizeof(cbor_word) <= len; i += sizeof(cbor_word)) {
+        r = map_key_compare_word(p1 + i, p2 + i);
+        if (r)
+            return r;
+    }
+    if (i == len)
+        return 0;
+
+    /* the tail: the last word overlaps bytes already found equal */
+    i = len - sizeof(cbor_word);
+    return map_key_compare_word(p1 + i, p2 + i);
+}
+
 static CborError validate_container(CborValue *it, int containerType, uint32_t flags, int recursionLeft)
 {
     CborError err;
     const uint8_t *previous = NULL;
     const uint8_t *previous_end = NULL;
+    uint64_t previous_len = 0;
 
     if (!recursionLeft)
         return CborErrorNestingTooDeep;
@@ -473,25 +532,25 @@ static CborError validate_container(CborValue *it, int containerType, uint32_t f
             continue;
 
         if (flags & CborValidateMapIsSorted) {
-            if (previous) {
-                uint64_t len1, len2;
-                const uint8_t *ptr;
-
-                /* extract the two lengths */
-                ptr = previous;
-                _cbor_value_extract_number(&ptr, it->parser->end, &len1);
-                ptr = current;
-                _cbor_value_extract_number(&ptr, it->parser->end, &len2);
+            /* the previous key's length is kept, so each key is decoded once */
+            uint64_t len = map_key_length(current, it->parser->end);
 
-                if (len1 > len2)
+            if (previous) {
+                if (previous_len > len)
                     return CborErrorMapNotSorted;
-                if (len1 == len2) {
-                    size_t bytelen1 = (size_t)(previous_end - previous);
-                    size_t bytelen2 = (size_t)(it->ptr - current);
-                    int r = memcmp(previous, current, bytelen1 <= bytelen2 ? bytelen1 : bytelen2);
-
-                    if (r == 0 && bytelen1 != bytelen2)
-                        r = bytelen1 < bytelen2 ? -1 : +1;
+                if (previous_len == len) {
+                    int r;
+                    if (map_key_is_short_text(*previous) && map_key_is_short_text(*current)) {
+                        /* same initial byte, so only the payloads can differ */
+                        r = map_key_compare(previous + 1, current + 1, (size_t)len);
+                    } else {
+                        size_t bytelen1 = (size_t)(previous_end - previous);
+                        size_t bytelen2 = (size_t)(it->ptr - current);
+                        r = memcmp(previous, current, bytelen1 <= bytelen2 ? bytelen1 : bytelen2);
+
+                        if (r == 0 && bytelen1 != bytelen2)
+                            r = bytelen1 < bytelen2 ? -1 : +1;
+                    }
                     if (r > 0)
                         return CborErrorMapNotSorted;
                     if (r == 0 && (flags & CborValidateMapKeysAreUnique) == CborValidateMapKeysAreUnique)
@@ -501,6 +560,7 @@ static CborError validate_container(CborValue *it, int containerType, uint32_t f
 
             previous = current;
             previous_end = it->ptr;
+            previous_len = len;
         }
 
         /* map: that was the key, so get the value */
@@ -665,6 +725,32 @@ CborError cbor_value_validate(const CborValue *it, uint32_t flags)
     return CborNoError;
 }
 
+/**
+ * Performs the same validation as cbor_value_validate() on the item pointed
+ * by \a it, but does not descend into it if it is an array or a map: only the
+ * container header (length encoding and whether the length is known) is
+ * checked.
+ *
+ * This allows an application that visits every element of a document to
+ * validate it while extracting the data, instead of running
+ * cbor_value_validate() over the whole document beforehand. Checks that
+ * relate elements to each other, like CborValidateMapIsSorted and
+ * CborValidateMapKeysAreUnique, are left to the caller.
+ *
+ * \sa cbor_value_validate()
+ */
+CborError cbor_value_validate_shallow(const CborValue *it, uint32_t flags)
+{
+    CborType type = cbor_value_get_type(it);
+
+    if (type != CborArrayType && type != CborMapType)
+        return cbor_value_validate(it, flags);
+
+    if (!cbor_value_is_length_known(it))
+        return (flags & CborValidateNoIndeterminateLength) ? CborErrorUnknownLength : CborNoError;
+    return validate_number(it, type, flags);
+}
+
 /**
  * @}
  */
@@ -165,6 +165,15 @@
 #endif
 
 
+/* the widest general purpose register, for code that reads several bytes at once */
+#if UINTPTR_MAX > 0xffffffffU
+typedef uint64_t cbor_word;
+#  define cbor_ntohw        cbor_ntohll
+#else
+typedef uint32_t cbor_word;
+#  define cbor_ntohw        cbor_ntohl
+#endif
+
 #ifdef __cplusplus
 #  define CONST_CAST(t, v)  const_cast<t>(v)
 #else
@@ -29,6 +29,12 @@
 
 #include <stdint.h>
 
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#endif
+
 static inline uint32_t get_utf8(const uint8_t **buffer, const uint8_t *end)
 {
     int charsNeeded;
@@ -101,4 +107,43 @@ static inline uint32_t get_utf8(const uint8_t **buffer, const uint8_t *end)
     return uc;
 }
 
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/* the first byte with a high bit in a block (bits: one per byte with a high bit, in order) */
+#  define first_high_byte(bits, bitsPerByte) ((size_t)__builtin_ctzll(bits) / (bitsPerByte))
+#else
+#  define first_high_byte(bits, bitsPerByte) ((size_t)0)
+#endif
+
+/* Skips ASCII 16 bytes at a time with SSE2 or NEON, then a word at a time. Returns
+ * the first byte with a high bit set (or the start of its block when that cannot be
+ * found cheaply), or the tail that does not fill a block, which get_utf8 decodes */
+static inline const uint8_t *skip_ascii(const uint8_t *buffer, const uint8_t *end)
+{
+    cbor_word w;
+
+#if defined(__SSE2__)
+    while (end - buffer >= 16) {
+        int bits = _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)buffer));
+        if (bits)
+            return buffer + first_high_byte((unsigned)bits, 1);
+        buffer += 16;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    while (end - buffer >= 16) {
+        if (vmaxvq_u8(vld1q_u8(buffer)) >= 0x80)
+            break;
+        buffer += 16;
+    }
+#endif
+
+    while (end - buffer >= (ptrdiff_t)sizeof(w)) {
+        memcpy(&w, buffer, sizeof(w));
+        w &= (cbor_word)UINT64_C(0x8080808080808080);
+        if (w)
+            return buffer + first_high_byte(w, 8);
+        buffer += sizeof(w);
+    }
+    return buffer;
+}
+
 #endif /* CBOR_UTF8_H */
@@ -96,6 +96,8 @@ private slots:
     void stringCompare();
     void mapFind_data();
     void mapFind();
+    void mapSeek_data();
+    void mapSeek();
 
     // validation & errors
     void checkedIntegers_data();
@@ -1339,6 +1341,82 @@ void tst_Parser::mapFind()
     }
 }
 
+void tst_Parser::mapSeek_data()
+{
+    // Rules:
+    //  we are seeking string "needle" from the first key, keys are in canonical order
+    //  if present, the value should be the string "haystack" (with tag 42)
+    //  if absent, the iterator stops at the end (empty "stop") or at the key "stop"
+
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("expected");
+    QTest::addColumn<QByteArray>("stop");
+
+    QTest::newRow("emptymap") << raw("\xa0") << false << QByteArray("");
+    QTest::newRow("_emptymap") << raw("\xbf\xff") << false << QByteArray("");
+
+    // maps not containing our items
+    QTest::newRow("absent-unsigned-unsigned") << raw("\xa1\0\0") << false << QByteArray("");
+    QTest::newRow("absent-shorter") << raw("\xa1\x61z\0") << false << QByteArray("");
+    QTest::newRow("absent-samelength-before") << raw("\xa1\x66needld\0") << false << QByteArray("");
+    QTest::newRow("absent-samelength-after") << raw("\xa2\x66needlf\0\x68haystack\0") << false << QByteArray("needlf");
+    QTest::newRow("absent-longer") << raw("\xa1\x68haystack\0") << false << QByteArray("haystack");
+    QTest::newRow("absent-longer-then-needle") << raw("\xa2\x68haystack\0\x66needle\0") << false << QByteArray("haystack");
+    QTest::newRow("absent-tagged") << raw("\xa1\xc1\x66needle\xd8\x2a\x68haystack") << false << QByteArray("");
+    QTest::newRow("absent-chunked") << raw("\xa1\x7f\x66needle\xff\xd8\x2a\x68haystack") << false << QByteArray("");
+    QTest::newRow("absent-longheader") << raw("\xa1\x78\x06needle\xd8\x2a\x68haystack") << false << QByteArray("needle");
+
+    // maps containing our items
+    QTest::newRow("alone") << raw("\xa1\x66needle\xd8\x2a\x68haystack") << true << QByteArray("");
+    QTest::newRow("1before") << raw("\xa2\x61z\0\x66needle\xd8\x2a\x68haystack") << true << QByteArray("");
+    QTest::newRow("samelength-before") << raw("\xa2\x66needld\0\x66needle\xd8\x2a\x68haystack") << true << QByteArray("");
+    QTest::newRow("taggedbefore") << raw("\xa2\xc1\x61z\xc1\0\x66needle\xd8\x2a\x68haystack") << true << QByteArray("");
+    QTest::newRow("arraybefore") << raw("\xa2\x61z\x81\x81\0\x66needle\xd8\x2a\x68haystack") << true << QByteArray("");
+    QTest::newRow("mapbefore") << raw("\xa2\xa1\1\2\xa0\x66needle\xd8\x2a\x68haystack") << true << QByteArray("");
+    QTest::newRow("1after") << raw("\xa2\x66needle\xd8\x2a\x68haystack\x68haystack\0") << true << QByteArray("");
+    QTest::newRow("_1before") << raw("\xbf\x61z\0\x66needle\xd8\x2a\x68haystack\xff") << true << QByteArray("");
+}
+
+void tst_Parser::mapSeek()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(bool, expected);
+    QFETCH(QByteArray, stop);
+
+    ParserWrapper w;
+    CborError err = w.init(data);
+    QVERIFY2(!err, QByteArray("Got error \"") + cbor_error_string(err) + "\"");
+
+    CborValue element;
+    err = cbor_value_enter_container(&w.first, &element);
+    QVERIFY2(!err, QByteArray("Got error \"") + cbor_error_string(err) + "\"");
+
+    bool found;
+    err = cbor_value_map_seek_key(&element, "needle", strlen("needle"), &found);
+    QVERIFY2(!err, QByteArray("Got error \"") + cbor_error_string(err) + "\"");
+    QCOMPARE(found, expected);
+
+    bool equals;
+    if (expected) {
+        QCOMPARE(int(element.type), int(CborTagType));
+
+        CborTag tag;
+        err = cbor_value_get_tag(&element, &tag);
+        QVERIFY2(!err, QByteArray("Got error \"") + cbor_error_string(err) + "\"");
+        QCOMPARE(int(tag), 42);
+
+        err = cbor_value_text_string_equals(&element, "haystack", &equals);
+        QVERIFY2(!err, QByteArray("Got error \"") + cbor_error_string(err) + "\"");
+        QVERIFY(equals);
+    } else if (stop.isEmpty()) {
+        QVERIFY(cbor_value_at_end(&element));
+    } else {
+        err = cbor_value_text_string_equals(&element, stop.constData(), &equals);
+        QVERIFY2(!err, QByteArray("Got error \"") + cbor_error_string(err) + "\"");
+        QVERIFY(equals);
+    }
+}
+
 void tst_Parser::checkedIntegers_data()
 {
     QTest::addColumn<QByteArray>("data");
@@ -1834,6 +1912,10 @@ void tst_Parser::strictValidation_data()
     QTest::newRow("unsorted-length-map-AS") << raw("\xa2\x83\0\x20\x45Hello\1\x60\0") << int(CborValidateCanonicalFormat) << CborErrorMapNotSorted;
     QTest::newRow("unsorted-content-map-SS") << raw("\xa2\x61z\1\x61y\0") << int(CborValidateCanonicalFormat) << CborErrorMapNotSorted;
     QTest::newRow("unsorted-content-map-AS") << raw("\xa2\x81\x21\1\x61\x21\0") << int(CborValidateCanonicalFormat) << CborErrorMapNotSorted;
+    // text keys longer than a word are compared a word at a time, then by the last (overlapping) word
+    QTest::newRow("sorted-content-map-long-SS") << raw("\xa2\x69" "abcdefghy" "\1\x69" "abcdefghz" "\0") << int(CborValidateCanonicalFormat) << CborNoError;
+    QTest::newRow("unsorted-content-map-long-SS-last") << raw("\xa2\x69" "abcdefghz" "\1\x69" "abcdefghy" "\0") << int(CborValidateCanonicalFormat) << CborErrorMapNotSorted;
+    QTest::newRow("unsorted-content-map-long-SS-first") << raw("\xa2\x71" "bbcdefghijklmnopq" "\1\x71" "abcdefghijklmnopq" "\0") << int(CborValidateCanonicalFormat) << CborErrorMapNotSorted;
 
     QTest::newRow("tag-0") << raw("\xc0\x60") << int(CborValidateCanonicalFormat) << CborNoError;
     QTest::newRow("tag-24") << raw("\xd8\x18\x40") << int(CborValidateCanonicalFormat) << CborNoError;
@@ -1882,6 +1964,10 @@ void tst_Parser::strictValidation_data()
 
     // strict mode
     // UTF-8 sequences with invalid continuation bytes
+    // ASCII is skipped a block at a time, these have the first high bit after a block
+    QTest::newRow("utf8-long-2char") << raw("\x74" "abcdefghijklmnopqr" "\xc3\xa9") << int(CborValidateStrictMode) << CborNoError;
+    QTest::newRow("invalid-utf8-long-bad-continuation-1char") << raw("\x74" "abcdefghijklmnopqrs" "\x80") << int(CborValidateStrictMode) << CborErrorInvalidUtf8TextString;
+    QTest::newRow("invalid-utf8-long-bad-continuation-2chars") << raw("\x77" "abcdefghijklmnopqrstu" "\xc3" "x") << int(CborValidateStrictMode) << CborErrorInvalidUtf8TextString;
     QTest::newRow("invalid-utf8-bad-continuation-1char") << raw("\x61\x80") << int(CborValidateStrictMode) << CborErrorInvalidUtf8TextString;
     QTest::newRow("invalid-utf8-bad-continuation-2chars-1") << raw("\x62\xc2\xc0") << int(CborValidateStrictMode) << CborErrorInvalidUtf8TextString;
     QTest::newRow("invalid-utf8-bad-continuation-2chars-2") << raw("\x62\xc3\xdf") << int(CborValidateStrictMode) << CborErrorInvalidUtf8TextString;
@@ -1928,6 +2014,7 @@ void tst_Parser::strictValidation_data()
 
     QTest::newRow("nonunique-content-map-UU") << raw("\xa2\0\1\0\2") << int(CborValidateStrictMode) << CborErrorMapKeysNotUnique;
     QTest::newRow("nonunique-content-map-SS") << raw("\xa2\x61z\1\x61z\2") << int(CborValidateStrictMode) << CborErrorMapKeysNotUnique;
+    QTest::newRow("nonunique-content-map-long-SS") << raw("\xa2\x71" "abcdefghijklmnopq" "\1\x71" "abcdefghijklmnopq" "\2") << int(CborValidateStrictMode) << CborErrorMapKeysNotUnique;
     QTest::newRow("nonunique-content-map-AA") << raw("\xa2\x81\x65Hello\1\x81\x65Hello\2") << int(CborValidateStrictMode) << CborErrorMapKeysNotUnique;
 
     QTest::newRow("tag-0-unsigned") << raw("\xc0\x00") << int(CborValidateStrictMode) << CborErrorInappropriateTagForType;
@@ -0,0 +1,252 @@
+#!/usr/bin/env python3
+#*******************************************************************************
+#*   (c) 2019 ZondaX GmbH
+#*
+#*  Licensed under the Apache License, Version 2.0 (the "License");
+#*  you may not use this file except in compliance with the License.
+#*  You may obtain a copy of the License at
+#*
+#*      http://www.apache.org/licenses/LICENSE-2.0
+#*
+#*  Unless required by applicable law or agreed to in writing, software
+#*  distributed under the License is distributed on an "AS IS" BASIS,
+#*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#*  See the License for the specific language governing permissions and
+#*  limitations under the License.
+#********************************************************************************
+"""RAM and stack budget report.
+
+Lists the size of every .data/.bss symbol (nm -S) and, from the frame sizes the
+compiler writes with -fstack-usage (*.su) and the calls found in the
+disassembly (objdump -d), the worst-case stack path from each root function.
+Exits with 1 when the RAM or the stack of a root is over budget.
+
+The budgets default to the linker script: RAM is SRAM minus STACK_SIZE, the
+stack is STACK_SIZE. Symbols starting with N_ live in flash (see script.ld) and
+are listed apart.
+
+The stack depth is a static bound with these limits, listed in the report:
+- calls through function pointers are not followed
+- a recursive call is counted once
+- functions without a frame size (libc, SDK objects built without
+  -fstack-usage) count as 0
+- static functions with the same name in several files use the largest frame
+"""
+
+import argparse
+import collections
+import os
+import re
+import subprocess
+import sys
+
+# nm types of initialized and zero-initialized data
+DATA_TYPES = {'d': '.data', 'D': '.data', 'b': '.bss', 'B': '.bss', 'C': '.bss'}
+
+FUNCTION_RE = re.compile(r'^[0-9a-f]+ <(?P<name>[^>]+)>:$')
+# call, jmp, bl, b.w, beq... to the start of a function. Jumps inside a function show as <name+0x..>
+BRANCH_RE = re.compile(r'^\s*[0-9a-f]+:\s+(?:\S+\s+)*?[0-9a-f]+ <(?P<name>[^>+]+)>$')
+INDIRECT_CALL_RE = re.compile(r'^\s*[0-9a-f]+:\s+(?:call\w*\s+\*|blx\s+r\d)')
+
+
+def run(tool, *args):
+    try:
+        return subprocess.run([tool] + list(args), check=True, stdout=subprocess.PIPE,
+                              universal_newlines=True).stdout
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit('ram_report: {} failed: {}'.format(tool, e))
+
+
+def read_symbols(nm, paths):
+    """(size, section, name, object) of data symbols, archives give the object of each one"""
+    symbols = []
+    for path in paths:
+        obj = ''
+        for line in run(nm, '-S', path).splitlines():
+            if line.endswith(':'):
+                obj = os.path.basename(line[:-1])
+                continue
+            fields = line.split()
+            if len(fields) == 4 and fields[2] in DATA_TYPES:
+                symbols.append((int(fields[1], 16), DATA_TYPES[fields[2]], fields[3], obj))
+    return symbols
+
+
+def read_frames(dirs):
+    """Frame size and qualifiers (static, dynamic, bounded) of each function in the .su files"""
+    frames = {}
+    for top in dirs:
+        for root, _, files in os.walk(top):
+            for f in files:
+                if not f.endswith('.su'):
+                    continue
+                with open(os.path.join(root, f)) as su:
+                    for line in su:
+                        location, size, qualifiers = line.rstrip('\n').split('\t')
+                        name = location.split(':', 3)[-1]
+                        if name not in frames or frames[name][0] < int(size):
+                            frames[name] = (int(size), qualifiers)
+    return frames
+
+
+def find_frame(frames, name):
+    """.su files drop the number of compiler clones: foo.constprop.0 is foo.constprop there"""
+    return frames.get(name) or frames.get(re.sub(r'\.\d+$', '', name))
+
+
+def read_calls(objdump, elf):
+    """Callees and functions with indirect calls, from the disassembly of the linked binary"""
+    calls = collections.defaultdict(set)
+    indirect = set()
+    current = None
+    for line in run(objdump, '-d', '--no-show-raw-insn', elf).splitlines():
+        m = FUNCTION_RE.match(line)
+        if m:
+            current = m.group('name')
+            calls[current]
+            continue
+        if current is None:
+            continue
+        # drop comments (x86 "# addr <sym>", arm "; (addr <sym>)"), they are data references
+        code = re.split(r'\s[#;]', line, maxsplit=1)[0]
+        m = BRANCH_RE.match(code)
+        if m:
+            calls[current].add(m.group('name'))
+        elif INDIRECT_CALL_RE.match(code):
+            indirect.add(current)
+    return calls, indirect
+
+
+def read_ldscript(path):
+    """(SRAM length, STACK_SIZE) of a linker script"""
+    with open(path) as f:
+        text = f.read()
+    sram = re.search(r'SRAM\s*\([^)]*\)\s*:\s*ORIGIN\s*=\s*\w+\s*,\s*LENGTH\s*=\s*(\d+)\s*([KM]?)', text)
+    stack = re.search(r'STACK_SIZE\s*=\s*(\d+)\s*;', text)
+    if not sram or not stack:
+        sys.exit('ram_report: SRAM or STACK_SIZE not found in {}'.format(path))
+    length = int(sram.group(1)) * {'': 1, 'K': 1024, 'M': 1024 * 1024}[sram.group(2)]
+    return length, int(stack.group(1))
+
+
+class StackWalk:
+    def __init__(self, frames, calls):
+        self.frames = frames
+        self.calls = calls
+        self.worst = {}
+        self.active = set()
+        self.recursive = set()
+        self.unknown = set()
+
+    def frame(self, name):
+        frame = find_frame(self.frames, name)
+        if frame:
+            return frame[0]
+        self.unknown.add(name)
+        return 0
+
+    def depth(self, name):
+        """Worst-case stack below and including name, and the callee it goes through"""
+        if name in self.worst:
+            return self.worst[name][0]
+        if name in self.active:
+            self.recursive.add(name)
+            return 0
+        self.active.add(name)
+        deepest, through = 0, None
+        for callee in sorted(self.calls.get(name, ())):
+            d = self.depth(callee)
+            if d > deepest:
+                deepest, through = d, callee
+        self.active.discard(name)
+        self.worst[name] = (self.frame(name) + deepest, through)
+        return self.worst[name][0]
+
+    def path(self, name):
+        seen = set()
+        while name is not None and name not in seen:
+            seen.add(name)
+            yield name
+            name = self.worst.get(name, (0, None))[1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--elf', required=True, help='linked binary, for the calls between functions')
+    parser.add_argument('--symbols', action='append',
+                        help='files to list data symbols from (binary or archive), default: --elf')
+    parser.add_argument('--su', action='append', required=True, help='directory with the .su files')
+    parser.add_argument('--root', action='append', required=True, help='function to report the stack of')
+    parser.add_argument('--ldscript', help='linker script the budgets default to')
+    parser.add_argument('--ram-budget', type=int, default=0, help='bytes of .data + .bss (0: from --ldscript)')
+    parser.add_argument('--stack-budget', type=int, default=0, help='bytes of stack (0: from --ldscript)')
+    parser.add_argument('--nm', default='nm')
+    parser.add_argument('--objdump', default='objdump')
+    parser.add_argument('--frames', type=int, default=10, help='largest frames to list')
+    args = parser.parse_args()
+
+    ram_budget, stack_budget = args.ram_budget, args.stack_budget
+    if args.ldscript:
+        sram, stack_size = read_ldscript(args.ldscript)
+        ram_budget = ram_budget or sram - stack_size
+        stack_budget = stack_budget or stack_size
+
+    over = False
+
+    symbols = sorted(read_symbols(args.nm, args.symbols or [args.elf]), key=lambda s: (-s[0], s[2]))
+    ram = [s for s in symbols if not s[2].startswith('N_')]
+    nvm = [s for s in symbols if s[2].startswith('N_')]
+
+    print('RAM')
+    for size, section, name, obj in ram:
+        print('  {:6d}  {:5s}  {:32s} {}'.format(size, section, name, obj))
+    total = sum(s[0] for s in ram)
+    print('  {:6d}  total (.data {}, .bss {})'.format(total,
+                                                      sum(s[0] for s in ram if s[1] == '.data'),
+                                                      sum(s[0] for s in ram if s[1] == '.bss')))
+    if ram_budget:
+        print('  {:6d}  budget{}'.format(ram_budget, ' EXCEEDED' if total > ram_budget else ''))
+        over |= total > ram_budget
+    for size, section, name, obj in nvm:
+        print('  {:6d}  flash  {:32s} {}'.format(size, name, obj))
+
+    frames = read_frames(args.su)
+    calls, indirect = read_calls(args.objdump, args.elf)
+    walk = StackWalk(frames, calls)
+
+    for root in args.root:
+        if root not in calls:
+            sys.exit('ram_report: {} is not in {}'.format(root, args.elf))
+        depth = walk.depth(root)
+        print('\nStack from {}'.format(root))
+        for name in walk.path(root):
+            size, qualifiers = find_frame(frames, name) or (0, 'unknown')
+            notes = [q for q in qualifiers.split(',') if q != 'static']
+            if name in indirect:
+                notes.append('indirect calls')
+            if name in walk.recursive:
+                notes.append('recursive')
+            print('  {:6d}  {:40s} {}'.format(size, name, ' '.join(notes)))
+        print('  {:6d}  worst case'.format(depth))
+        if stack_budget:
+            print('  {:6d}  budget{}'.format(stack_budget, ' EXCEEDED' if depth > stack_budget else ''))
+            over |= depth > stack_budget
+
+    reached = {n: find_frame(frames, n) for n in walk.worst if find_frame(frames, n)}
+    print('\nLargest frames reached from the roots')
+    for name in sorted(reached, key=lambda n: (-reached[n][0], n))[:args.frames]:
+        print('  {:6d}  {:40s} {}'.format(reached[name][0], name, reached[name][1]))
+
+    notes = [('indirect calls not followed in', sorted(set(walk.worst) & indirect)),
+             ('recursion counted once in', sorted(walk.recursive)),
+             ('dynamic frames in', sorted(n for n in reached if 'dynamic' in reached[n][1])),
+             ('no frame size for', sorted(n for n in walk.unknown if not n.endswith('@plt')))]
+    for text, names in notes:
+        if names:
+            print('\n{}: {}'.format(text, ', '.join(names)))
+
+    return 1 if over else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,33 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Links the host build of the transaction code so ram_report.py can follow its calls
+// The view is not built on the host: tx_getItem is what h_review_update_data calls for each page
+
+#include "tx.h"
+
+int main() {
+    char key[40];
+    char value[40];
+    uint8_t pageCount;
+
+    tx_initialize();
+    tx_reset();
+    if (tx_parse() != NULL && tx_parse_batch() != NULL) {
+        return 1;
+    }
+    return tx_getItem(0, key, sizeof(key), value, sizeof(value), 0, &pageCount);
+}
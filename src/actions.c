@@ -25,11 +25,18 @@
 uint8_t app_sign() {
     uint8_t *signature = G_io_apdu_buffer;
 
-    // Skip first byte (context length)
-    const uint8_t *message = tx_get_buffer() + 1;
-    const uint16_t messageLength = tx_get_buffer_length() - 1;
+    uint8_t messageDigest[CX_SHA512_SIZE];
+    if (tx_is_batch()) {
+        // Batch transactions are signed in order, one per reply
+        if (!tx_batch_next_digest(messageDigest)) {
+            return 0;
+        }
+    } else {
+        // Message was hashed as it was received (first byte, the context length, is skipped)
+        tx_get_digest(messageDigest);
+    }
 
-    return crypto_sign(signature, IO_APDU_BUFFER_SIZE - 2, message, messageLength);
+    return crypto_sign(signature, IO_APDU_BUFFER_SIZE - 2, messageDigest, sizeof(messageDigest));
 }
 
 uint8_t app_fill_address() {
@@ -38,6 +45,12 @@ uint8_t app_fill_address() {
     return crypto_fillAddress(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE - 2);
 }
 
+uint16_t app_fill_public_keys(uint8_t component, uint32_t start, uint8_t count) {
+    // Put data directly in the apdu buffer
+    MEMZERO(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE);
+    return crypto_fillPublicKeys(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE - 2, component, start, count);
+}
+
 void app_reply_address() {
     const uint8_t replyLen = app_fill_address();
     set_code(G_io_apdu_buffer, replyLen, APDU_CODE_OK);
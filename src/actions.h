@@ -21,6 +21,8 @@ uint8_t app_sign();
 
 uint8_t app_fill_address();
 
+uint16_t app_fill_public_keys(uint8_t component, uint32_t start, uint8_t count);
+
 void app_reply_address();
 
 void app_reply_error();
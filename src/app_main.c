@@ -30,6 +30,9 @@
 
 unsigned char G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
 
+// Path of the batch under review, later address requests must not change it
+uint32_t batchPath[BIP44_LEN_DEFAULT];
+
 unsigned char io_event(unsigned char channel) {
     switch (G_io_seproxyhal_spi_buffer[0]) {
         case SEPROXYHAL_TAG_FINGER_EVENT: //
@@ -127,6 +130,13 @@ bool process_chunk(volatile uint32_t *tx, uint32_t rx) {
             tx_initialize();
             tx_reset();
             extractBip44(rx, OFFSET_DATA);
+            if (rx >= OFFSET_TOTAL_LENGTH + sizeof(uint32_t)) {
+                uint32_t totalLength;
+                MEMCPY(&totalLength, G_io_apdu_buffer + OFFSET_TOTAL_LENGTH, sizeof(uint32_t));
+                if (!tx_reserve(totalLength)) {
+                    THROW(APDU_CODE_OUTPUT_BUFFER_TOO_SMALL);
+                }
+            }
             return false;
         case 1:
             added = tx_append(&(G_io_apdu_buffer[OFFSET_DATA]), rx - OFFSET_DATA);
@@ -139,6 +149,7 @@ bool process_chunk(volatile uint32_t *tx, uint32_t rx) {
             if (added != rx - OFFSET_DATA) {
                 THROW(APDU_CODE_OUTPUT_BUFFER_TOO_SMALL);
             }
+            tx_flush();
             return true;
     }
 
@@ -199,6 +210,32 @@ void handleApdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
                     break;
                 }
 
+                case INS_GET_PUBKEYS_ED25519: {
+                    if (rx < PUBKEYS_MIN_LENGTH) {
+                        THROW(APDU_CODE_WRONG_LENGTH);
+                    }
+                    extractBip44(rx, OFFSET_DATA);
+
+                    const uint8_t component = G_io_apdu_buffer[OFFSET_PUBKEYS_COMPONENT];
+                    if (component != PUBKEYS_COMPONENT_ACCOUNT && component != PUBKEYS_COMPONENT_ADDRESS) {
+                        THROW(APDU_CODE_INVALIDP1P2);
+                    }
+
+                    uint32_t start;
+                    MEMCPY(&start, G_io_apdu_buffer + OFFSET_PUBKEYS_START, sizeof(uint32_t));
+                    const uint8_t count = G_io_apdu_buffer[OFFSET_PUBKEYS_COUNT];
+
+                    // All indexes must be hardened, or none of them
+                    const uint32_t last = start + count - 1;
+                    if (count == 0 || last < start || ((start ^ last) & 0x80000000u) != 0) {
+                        THROW(APDU_CODE_DATA_INVALID);
+                    }
+
+                    *tx = app_fill_public_keys(component, start, count);
+                    THROW(APDU_CODE_OK);
+                    break;
+                }
+
                 case INS_SIGN_ED25519: {
                     if (!process_chunk(tx, rx))
                         THROW(APDU_CODE_OK);
@@ -217,6 +254,39 @@ void handleApdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
                     break;
                 }
 
+                case INS_SIGN_BATCH_ED25519: {
+                    if (G_io_apdu_buffer[OFFSET_PAYLOAD_TYPE] == PAYLOAD_TYPE_NEXT_SIGNATURE) {
+                        // The first signature is sent when the batch is approved
+                        if (!tx_is_batch() || tx_batch_get_signed_count() == 0) {
+                            THROW(APDU_CODE_COMMAND_NOT_ALLOWED);
+                        }
+
+                        MEMCPY(bip44Path, batchPath, sizeof(batchPath));
+                        *tx = app_sign();
+                        if (*tx == 0) {
+                            THROW(APDU_CODE_COMMAND_NOT_ALLOWED);
+                        }
+                        THROW(APDU_CODE_OK);
+                    }
+
+                    if (!process_chunk(tx, rx))
+                        THROW(APDU_CODE_OK);
+
+                    const char *error_msg = tx_parse_batch();
+
+                    if (error_msg != NULL) {
+                        int error_msg_length = strlen(error_msg);
+                        MEMCPY(G_io_apdu_buffer, error_msg, error_msg_length);
+                        *tx += (error_msg_length);
+                        THROW(APDU_CODE_DATA_INVALID);
+                    }
+
+                    MEMCPY(batchPath, bip44Path, sizeof(batchPath));
+                    view_sign_show();
+                    *flags |= IO_ASYNCH_REPLY;
+                    break;
+                }
+
                 default:
                     THROW(APDU_CODE_INS_NOT_SUPPORTED);
             }
@@ -273,6 +343,7 @@ void handle_generic_apdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32
 }
 
 void app_init() {
+    crypto_clearAddressCache();
     io_seproxyhal_init();
     USB_power(0);
     USB_power(1);
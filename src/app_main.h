@@ -33,9 +33,26 @@
 #define OFFSET_PAYLOAD_TYPE             OFFSET_P1
 #define OFFSET_CONTEXT                  (OFFSET_DATA + sizeof(uint32_t) * BIP44_LEN_DEFAULT)
 
+// Optional in the init chunk, after the path: total length of the chunks that follow
+#define OFFSET_TOTAL_LENGTH             (OFFSET_DATA + sizeof(uint32_t) * BIP44_LEN_DEFAULT)
+
+// INS_GET_PUBKEYS_ED25519: base path, then the first index and the number of keys
+#define OFFSET_PUBKEYS_COMPONENT        OFFSET_P1
+#define OFFSET_PUBKEYS_START            (OFFSET_DATA + sizeof(uint32_t) * BIP44_LEN_DEFAULT)
+#define OFFSET_PUBKEYS_COUNT            (OFFSET_PUBKEYS_START + sizeof(uint32_t))
+#define PUBKEYS_MIN_LENGTH              (OFFSET_PUBKEYS_COUNT + 1)
+
+#define PUBKEYS_COMPONENT_ACCOUNT       2
+#define PUBKEYS_COMPONENT_ADDRESS       4
+
 #define INS_GET_VERSION                 0
 #define INS_GET_ADDR_ED25519            1
 #define INS_SIGN_ED25519                2
+#define INS_GET_PUBKEYS_ED25519         3
+#define INS_SIGN_BATCH_ED25519          4
+
+// INS_SIGN_BATCH_ED25519: P1 to get the signatures after the first one
+#define PAYLOAD_TYPE_NEXT_SIGNATURE     3
 
 void app_init();
 
@@ -0,0 +1,76 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <string.h>
+#include <zxmacros.h>
+#include "addr_cache.h"
+
+__Z_INLINE void addr_cache_touch(addr_cache_t *cache, addr_cache_entry_t *entry) {
+    cache->clock++;
+    if (cache->clock == 0) {
+        // wrapped around, restart the order from the current one
+        for (uint8_t i = 0; i < ADDR_CACHE_ENTRIES; i++) {
+            if (cache->entries[i].lastUse != 0) {
+                cache->entries[i].lastUse = 1;
+            }
+        }
+        cache->clock = 2;
+    }
+    entry->lastUse = cache->clock;
+}
+
+void addr_cache_init(addr_cache_t *cache) {
+    MEMZERO(cache, sizeof(addr_cache_t));
+}
+
+const addr_cache_entry_t *addr_cache_lookup(addr_cache_t *cache, const uint32_t path[ADDR_CACHE_PATH_LEN]) {
+    for (uint8_t i = 0; i < ADDR_CACHE_ENTRIES; i++) {
+        addr_cache_entry_t *entry = &cache->entries[i];
+        if (entry->lastUse != 0 && MEMCMP(entry->path, path, sizeof(entry->path)) == 0) {
+            cache->hits++;
+            addr_cache_touch(cache, entry);
+            return entry;
+        }
+    }
+
+    cache->misses++;
+    return NULL;
+}
+
+const addr_cache_entry_t *addr_cache_insert(addr_cache_t *cache,
+                                            const uint32_t path[ADDR_CACHE_PATH_LEN],
+                                            const uint8_t publicKey[ADDR_CACHE_PK_LEN],
+                                            const char *address) {
+    const size_t addressLen = strlen(address);
+    if (addressLen >= sizeof(cache->entries[0].address)) {
+        return NULL;
+    }
+
+    // empty entries have the oldest lastUse
+    addr_cache_entry_t *entry = &cache->entries[0];
+    for (uint8_t i = 1; i < ADDR_CACHE_ENTRIES; i++) {
+        if (cache->entries[i].lastUse < entry->lastUse) {
+            entry = &cache->entries[i];
+        }
+    }
+
+    MEMZERO(entry, sizeof(addr_cache_entry_t));
+    MEMCPY(entry->path, path, sizeof(entry->path));
+    MEMCPY(entry->publicKey, publicKey, sizeof(entry->publicKey));
+    MEMCPY(entry->address, address, addressLen + 1);
+    addr_cache_touch(cache, entry);
+    return entry;
+}
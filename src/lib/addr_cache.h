@@ -0,0 +1,66 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <bech32.h>
+#include "coin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ADDR_CACHE_PATH_LEN     5u
+#define ADDR_CACHE_PK_LEN       32u
+// An entry takes about 120 B, the Nano S only remembers the last address
+#if defined(TARGET_NANOS)
+#define ADDR_CACHE_ENTRIES      1u
+#else
+#define ADDR_CACHE_ENTRIES      4u
+#endif
+
+// Public key and address of a BIP44 path. No private key material is kept
+typedef struct {
+    uint32_t path[ADDR_CACHE_PATH_LEN];
+    uint8_t publicKey[ADDR_CACHE_PK_LEN];
+    char address[BECH32_BYTES32_ADDR_LEN(sizeof(COIN_HRP) - 1) + 1];
+    uint32_t lastUse;           // 0 if the entry is empty
+} addr_cache_entry_t;
+
+// Least recently used entries are replaced first
+typedef struct {
+    addr_cache_entry_t entries[ADDR_CACHE_ENTRIES];
+    uint32_t clock;
+    uint16_t hits;
+    uint16_t misses;
+} addr_cache_t;
+
+//// empties the cache and resets the counters
+void addr_cache_init(addr_cache_t *cache);
+
+//// returns the entry of path, or NULL. Counts a hit or a miss
+const addr_cache_entry_t *addr_cache_lookup(addr_cache_t *cache, const uint32_t path[ADDR_CACHE_PATH_LEN]);
+
+//// stores the public key and address of path, replacing the least recently used entry
+const addr_cache_entry_t *addr_cache_insert(addr_cache_t *cache,
+                                            const uint32_t path[ADDR_CACHE_PATH_LEN],
+                                            const uint8_t publicKey[ADDR_CACHE_PK_LEN],
+                                            const char *address);
+
+#ifdef __cplusplus
+}
+#endif
@@ -32,9 +32,21 @@ __Z_INLINE parser_error_t parser_mapCborError(CborError err) {
 
 #define sizeof_field(type, member) sizeof(((type *)0)->member)
 
-#define CHECK_CBOR_ERR(err) {if (err!=CborNoError) return parser_mapCborError(err);}
+#define CHECK_CBOR_ERR(CALL) {CborError __err = CALL; if (__err!=CborNoError) return parser_mapCborError(__err);}
 #define CHECK_CBOR_TYPE(type, expected) {if (type!=expected) return parser_unexpected_type;}
+
+// Items are validated as they are consumed instead of validating the whole buffer up front.
+// tinycbor does not interpret parser flags, so each parser carries the validation flags
+// that apply to its buffer (CborValidateCanonicalFormat or CborValidateBasic)
+// CBOR_FLAG_VALIDATED (an unused tinycbor validation bit) marks buffers that were already
+// validated while they were received (see parser_stream.h), so the checks are skipped
+#define CBOR_FLAG_VALIDATED 0x1000000u
+#define CBOR_IS_VALIDATED(value) (((value)->parser->flags & CBOR_FLAG_VALIDATED) != 0)
+#define CHECK_CBOR_CANONICAL(value) { \
+    if (!CBOR_IS_VALIDATED(value)) CHECK_CBOR_ERR(cbor_value_validate_shallow(value, (value)->parser->flags)) }
+
 #define CHECK_CBOR_MAP_LEN(map, expected_count) { \
+    CHECK_CBOR_CANONICAL(map) \
     size_t numItems; CHECK_CBOR_ERR(cbor_value_get_map_length(map, &numItems)); \
     if (numItems != expected_count)  return parser_unexpected_number_items; }
 
@@ -42,15 +54,22 @@ __Z_INLINE parser_error_t parser_mapCborError(CborError err) {
     CborParser parser;           \
     CHECK_CBOR_ERR(cbor_parser_init(c->buffer + c->offset, c->bufferLen - c->offset, 0, &parser, &it))
 
-__Z_INLINE parser_error_t _matchKey(CborValue *value, const char *expectedKey) {
-    CHECK_CBOR_TYPE(cbor_value_get_type(value), CborTextStringType)
+// Maps are read with a forward-only cursor: keys are expected in canonical order,
+// so each map is walked once (see cbor_value_map_seek_key)
+__Z_INLINE parser_error_t _seekOptionalKey(CborValue *contents, const char *expectedKey, bool *found) {
+    if (!cbor_value_at_end(contents)) {
+        CHECK_CBOR_CANONICAL(contents)
+    }
+    CHECK_CBOR_ERR(cbor_value_map_seek_key(contents, expectedKey, strlen(expectedKey), found))
+    return parser_ok;
+}
 
-    bool result;
-    CHECK_CBOR_ERR(cbor_value_text_string_equals(value, expectedKey, &result))
-    if (!result) {
+// On success, contents points to the value of expectedKey
+__Z_INLINE parser_error_t _seekKey(CborValue *contents, const char *expectedKey) {
+    bool found;
+    CHECK_PARSER_ERR(_seekOptionalKey(contents, expectedKey, &found))
+    if (!found) {
         return parser_unexpected_field;
     }
-
     return parser_ok;
 }
-#define CBOR_KEY_MATCHES(v, key) (_matchKey(v, key) == parser_ok)
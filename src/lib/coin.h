@@ -29,10 +29,11 @@ extern "C" {
 #define BIP44_4_DEFAULT     (0)
 
 #define COIN_HRP            "oasis"
+// bech32HrpState(COIN_HRP)
+#define COIN_HRP_STATE      0x02f1f089u
 #define COIN_AMOUNT_DECIMAL_PLACES 9
 #define COIN_RATE_DECIMAL_PLACES 5
 
-#define MAX_RATES           10
 #define MAX_CONTEXT_SIZE    64
 #define MAX_ENTITY_NODES    16
 
@@ -20,9 +20,13 @@
 #include <bech32.h>
 #include "apdu_codes.h"
 #include "zxmacros.h"
+#include "addr_cache.h"
 
 uint32_t bip44Path[BIP44_LEN_DEFAULT];
 
+// Keys of recently queried paths, so repeated address requests skip derivation
+static addr_cache_t addr_cache;
+
 #if defined(TARGET_NANOS)
 #define SAFE_HEARTBEAT(X)  io_seproxyhal_io_heartbeat(); X; io_seproxyhal_io_heartbeat();
 #endif
@@ -31,6 +35,10 @@ uint32_t bip44Path[BIP44_LEN_DEFAULT];
 #define SAFE_HEARTBEAT(X)  X;
 #endif
 
+#ifndef SAFE_HEARTBEAT
+#define SAFE_HEARTBEAT(X)  X;
+#endif
+
 #if defined(TARGET_NANOS) || defined(TARGET_NANOX)
 #include "cx.h"
 
@@ -76,15 +84,13 @@ void crypto_extractPublicKey(uint32_t bip44Path[BIP44_LEN_DEFAULT], uint8_t *pub
 
 uint16_t crypto_sign(uint8_t *signature,
                      uint16_t signatureMaxlen,
-                     const uint8_t *message,
-                     uint16_t messageLen) {
-    uint8_t messageDigest[CX_SHA512_SIZE];
+                     const uint8_t *messageDigest,
+                     uint16_t messageDigestLen) {
     int signatureLength;
 
-    // Hash it
-    cx_sha512_t ctx;
-    cx_sha512_init((cx_sha512_t *)&ctx.header);
-    cx_hash(&ctx.header, CX_LAST, message, messageLen, messageDigest, CX_SHA512_SIZE);
+    if (messageDigestLen != CX_SHA512_SIZE) {
+        return 0;
+    }
 
     cx_ecfp_private_key_t cx_privateKey;
     uint8_t privateKeyData[32];
@@ -128,29 +134,74 @@ uint16_t crypto_sign(uint8_t *signature,
 }
 #else
 
-void crypto_extractPublicKey(uint32_t path[BIP32_LEN_DEFAULT], uint8_t *pubKey) {
+void crypto_extractPublicKey(uint32_t path[BIP44_LEN_DEFAULT], uint8_t *pubKey) {
     // Empty version for non-Ledger devices
+    UNUSED(path);
     MEMZERO(pubKey, 32);
 }
 
 uint16_t crypto_sign(uint8_t *signature,
                      uint16_t signatureMaxlen,
-                     const uint8_t *message,
-                     uint16_t messageLen) {
+                     const uint8_t *messageDigest,
+                     uint16_t messageDigestLen) {
     // Empty version for non-Ledger devices
+    UNUSED(signature);
+    UNUSED(signatureMaxlen);
+    UNUSED(messageDigest);
+    UNUSED(messageDigestLen);
     return 0;
 }
 
 #endif
 
+void crypto_clearAddressCache() {
+    addr_cache_init(&addr_cache);
+}
+
+void crypto_addressCacheStats(uint16_t *hits, uint16_t *misses) {
+    *hits = addr_cache.hits;
+    *misses = addr_cache.misses;
+}
+
 uint16_t crypto_fillAddress(uint8_t *buffer, uint16_t buffer_len) {
-    if (buffer_len < PK_LEN + 50) {
+    if (buffer_len < PK_LEN + sizeof(addr_cache.entries[0].address)) {
         return 0;
     }
 
-    // extract pubkey and encode as bech32
     char *addr = (char *) (buffer + PK_LEN);
+
+    const addr_cache_entry_t *entry = addr_cache_lookup(&addr_cache, bip44Path);
+    if (entry != NULL) {
+        MEMCPY(buffer, entry->publicKey, PK_LEN);
+        MEMCPY(addr, entry->address, sizeof(entry->address));
+        return PK_LEN + strlen(addr);
+    }
+
+    // extract pubkey and encode as bech32
     crypto_extractPublicKey(bip44Path, buffer);
-    bech32EncodeFromBytes(addr, COIN_HRP, buffer, PK_LEN);
+    bech32EncodeFromBytes32(addr, COIN_HRP, COIN_HRP_STATE, buffer);
+    addr_cache_insert(&addr_cache, bip44Path, buffer, addr);
     return PK_LEN + strlen(addr);
 }
+
+uint16_t crypto_fillPublicKeys(uint8_t *buffer, uint16_t buffer_len,
+                               uint8_t component, uint32_t start, uint8_t count) {
+    if (buffer_len < 1 || component >= BIP44_LEN_DEFAULT) {
+        return 0;
+    }
+
+    const uint16_t fit = (buffer_len - 1) / PK_LEN;
+    const uint8_t n = count < fit ? count : (uint8_t) fit;
+
+    uint32_t path[BIP44_LEN_DEFAULT];
+    MEMCPY(path, bip44Path, sizeof(path));
+
+    // [n][pk 0]...[pk n-1]
+    buffer[0] = n;
+    for (uint8_t i = 0; i < n; i++) {
+        path[component] = start + i;
+        SAFE_HEARTBEAT(crypto_extractPublicKey(path, buffer + 1 + i * PK_LEN));
+    }
+
+    return 1 + n * PK_LEN;
+}
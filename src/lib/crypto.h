@@ -31,10 +31,21 @@ extern uint32_t bip44Path[BIP44_LEN_DEFAULT];
 
 uint16_t crypto_fillAddress(uint8_t *buffer, uint16_t buffer_len);
 
+//// public keys of bip44Path with path[component] set to start, start + 1, ...
+//// writes [n][n * PK_LEN bytes] with as many keys (n <= count) as fit in buffer
+uint16_t crypto_fillPublicKeys(uint8_t *buffer, uint16_t buffer_len,
+                               uint8_t component, uint32_t start, uint8_t count);
+
+//// forgets the cached public keys and addresses
+void crypto_clearAddressCache();
+
+//// address requests served from the cache and requests that derived the key
+void crypto_addressCacheStats(uint16_t *hits, uint16_t *misses);
+
 uint16_t crypto_sign(uint8_t *signature,
                      uint16_t signatureMaxlen,
-                     const uint8_t *message,
-                     uint16_t messageLen);
+                     const uint8_t *messageDigest,
+                     uint16_t messageDigestLen);
 
 #ifdef __cplusplus
 }
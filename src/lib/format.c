@@ -0,0 +1,132 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <string.h>
+#include <zxmacros.h>
+#include <bech32.h>
+#include "format.h"
+
+// Room left for characters, the terminator is not counted
+__Z_INLINE uint16_t fmt_room(const fmt_buffer_t *f) {
+    return f->outLen == 0 ? 0 : (uint16_t) (f->outLen - 1 - f->len);
+}
+
+void fmt_init(fmt_buffer_t *f, char *out, uint16_t outLen) {
+    f->out = out;
+    f->outLen = outLen;
+    f->len = 0;
+    f->truncated = false;
+    if (outLen > 0) {
+        out[0] = 0;
+    }
+}
+
+void fmt_chars(fmt_buffer_t *f, const char *s, uint16_t len) {
+    const uint16_t room = fmt_room(f);
+    if (len > room) {
+        len = room;
+        f->truncated = true;
+    }
+    if (len == 0) {
+        return;
+    }
+    MEMCPY(f->out + f->len, s, len);
+    f->len += len;
+    f->out[f->len] = 0;
+}
+
+void fmt_literal(fmt_buffer_t *f, const char *s) {
+    fmt_chars(f, s, (uint16_t) strlen(s));
+}
+
+void fmt_uint(fmt_buffer_t *f, uint32_t value) {
+    // written from the end, 10 digits at most
+    char digits[10];
+    uint8_t i = sizeof(digits);
+    do {
+        digits[--i] = (char) ('0' + value % 10u);
+        value /= 10u;
+    } while (value != 0);
+    fmt_chars(f, digits + i, (uint16_t) (sizeof(digits) - i));
+}
+
+void fmt_uint64(fmt_buffer_t *f, uint64_t value) {
+    if (value <= UINT32_MAX) {
+        fmt_uint(f, (uint32_t) value);
+        return;
+    }
+
+    // 20 digits at most: the 64 bit divisions only run until the rest fits in 32 bits
+    char digits[20];
+    uint8_t i = sizeof(digits);
+    while (value > UINT32_MAX) {
+        digits[--i] = (char) ('0' + value % 10u);
+        value /= 10u;
+    }
+    uint32_t low = (uint32_t) value;
+    do {
+        digits[--i] = (char) ('0' + low % 10u);
+        low /= 10u;
+    } while (low != 0);
+    fmt_chars(f, digits + i, (uint16_t) (sizeof(digits) - i));
+}
+
+void fmt_hex(fmt_buffer_t *f, const uint8_t *data, uint16_t dataLen) {
+    const char hexchars[] = "0123456789ABCDEF";
+    const uint16_t room = fmt_room(f);
+    if (dataLen > room / 2) {
+        dataLen = room / 2;
+        f->truncated = true;
+    }
+    char *out = f->out + f->len;
+    for (uint16_t i = 0; i < dataLen; i++) {
+        *out++ = hexchars[data[i] >> 4u];
+        *out++ = hexchars[data[i] & 0x0Fu];
+    }
+    if (dataLen > 0) {
+        f->len += 2 * dataLen;
+        f->out[f->len] = 0;
+    }
+}
+
+void fmt_bech32(fmt_buffer_t *f, const char *hrp, uint32_t hrpState, const uint8_t data[32]) {
+    const uint16_t len = BECH32_BYTES32_ADDR_LEN(strlen(hrp));
+    if (len > fmt_room(f)) {
+        f->truncated = true;
+        return;
+    }
+    // writes its own terminator
+    bech32EncodeFromBytes32(f->out + f->len, hrp, hrpState, data);
+    f->len += (uint16_t) strlen(f->out + f->len);
+}
+
+void fmt_bip44(fmt_buffer_t *f, const uint32_t *path, uint8_t pathLen) {
+    for (uint8_t i = 0; i < pathLen; i++) {
+        if (i > 0) {
+            fmt_literal(f, "/");
+        }
+        fmt_uint(f, path[i] & 0x7FFFFFFFu);
+        if ((path[i] & 0x80000000u) != 0) {
+            fmt_literal(f, "'");
+        }
+    }
+}
+
+void fmt_copy(char *out, uint16_t outLen, const char *s) {
+    fmt_buffer_t f;
+    fmt_init(&f, out, outLen);
+    fmt_literal(&f, s);
+}
@@ -0,0 +1,64 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Text appended to a zero terminated buffer, a replacement for snprintf in the review items
+// As with snprintf, what does not fit is cut and the buffer stays terminated
+typedef struct {
+    char *out;
+    uint16_t outLen;            // including the zero terminator
+    uint16_t len;               // characters written
+    bool truncated;
+} fmt_buffer_t;
+
+//// starts an empty string in out, outLen can be 0
+void fmt_init(fmt_buffer_t *f, char *out, uint16_t outLen);
+
+//// appends a zero terminated string
+void fmt_literal(fmt_buffer_t *f, const char *s);
+
+//// appends len characters
+void fmt_chars(fmt_buffer_t *f, const char *s, uint16_t len);
+
+//// appends a number in base 10, indexes and counts
+void fmt_uint(fmt_buffer_t *f, uint32_t value);
+
+//// appends a number in base 10, only divides 64 bit values when they need it
+void fmt_uint64(fmt_buffer_t *f, uint64_t value);
+
+//// appends 2 uppercase hex digits per byte
+void fmt_hex(fmt_buffer_t *f, const uint8_t *data, uint16_t dataLen);
+
+//// appends the bech32 encoding of 32 bytes, nothing if it does not fit whole
+//// hrpState must be bech32HrpState(hrp)
+void fmt_bech32(fmt_buffer_t *f, const char *hrp, uint32_t hrpState, const uint8_t data[32]);
+
+//// appends a derivation path as bip44_to_str writes it: 44'/474'/0'/0'/0'
+void fmt_bip44(fmt_buffer_t *f, const uint32_t *path, uint8_t pathLen);
+
+//// writes s to out, the same as snprintf(out, outLen, "%s", s)
+void fmt_copy(char *out, uint16_t outLen, const char *s);
+
+#ifdef __cplusplus
+}
+#endif
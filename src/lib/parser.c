@@ -14,7 +14,6 @@
 *  limitations under the License.
 ********************************************************************************/
 
-#include <stdio.h>
 #include <zxmacros.h>
 #include <bech32.h>
 #include "lib/parser_impl.h"
@@ -23,6 +22,7 @@
 #include "parser.h"
 #include "parser_txdef.h"
 #include "coin.h"
+#include "format.h"
 
 #if defined(TARGET_NANOX)
 // For some reason NanoX requires this function
@@ -31,104 +31,286 @@ void __assert_fail(const char * assertion, const char * file, unsigned int line,
 }
 #endif
 
-parser_error_t parser_parse(parser_context_t *ctx, const uint8_t *data, uint16_t dataLen) {
-    CHECK_PARSER_ERR(parser_init(ctx, data, dataLen))
-    CHECK_PARSER_ERR(_readContext(ctx, &parser_tx_obj))
-    return _read(ctx, &parser_tx_obj);
+// State of the functions without one, the firmware parses a single transaction at a time
+parser_state_t parser_state;
+
+#define PUBLICKEY_DISPLAY_LEN   BECH32_BYTES32_ADDR_LEN(sizeof(COIN_HRP) - 1)
+#define SIGNATURE_DISPLAY_LEN   (2 * RAW_SIGNATURE_LEN)
+
+__Z_INLINE void parser_pageRendered(render_cache_t *cache,
+                                    char *outVal, uint16_t outValLen,
+                                    const char *rendered, uint16_t renderedLen,
+                                    uint8_t pageIdx, uint8_t *pageCount) {
+    if (renderedLen < sizeof(cache->value)) {
+        MEMCPY(cache->value, rendered, renderedLen + 1);
+        cache->pending = true;
+    }
+    pageStringExt(outVal, outValLen, rendered, renderedLen, pageIdx, pageCount);
 }
 
-parser_error_t parser_validate(const parser_context_t *ctx) {
-    CHECK_PARSER_ERR(_validateTx(ctx, &parser_tx_obj))
+__Z_INLINE const oasis_entity_t *parser_entity(const parser_tx_t *tx) {
+    if (tx->type == entityType) {
+        return &tx->oasis.entity;
+    }
+    return &tx->oasis.tx.body.registryRegisterEntity.entity;
+}
 
-    uint8_t numItems = parser_getNumItems(ctx);
+// Length of a formatted amount or rate, 0 if it cannot be formatted (printing reports the error)
+__Z_INLINE uint8_t parser_quantityLen(const quantity_t *q, uint8_t decimals, uint16_t suffixLen) {
+    if (q->len > QUANTITY_MAX_LEN) {
+        return 0;
+    }
+    // at most 155 digits, the point and the suffix
+    return (uint8_t) bignumBigEndian_to_fpstr_len(q->ptr, q->len, decimals, suffixLen);
+}
 
-    char tmpKey[40];
-    char tmpVal[40];
+#define AMOUNT_LEN(q)   parser_quantityLen(q, COIN_AMOUNT_DECIMAL_PLACES, 0)
+#define RATE_LEN(q)     parser_quantityLen(q, COIN_RATE_DECIMAL_PLACES - 2, 1)
+
+// What a display item shows. The kind names the field, rates, bounds and nodes also need their index
+typedef enum {
+    display_type,
+    display_fee_amount,
+    display_fee_gas,
+    display_transfer_to,
+    display_transfer_tokens,
+    display_burn_tokens,
+    display_add_escrow_account,
+    display_add_escrow_tokens,
+    display_reclaim_escrow_account,
+    display_reclaim_escrow_shares,
+    display_rate_start,
+    display_rate,
+    display_bound_start,
+    display_bound_min,
+    display_bound_max,
+    display_unfreeze_node_id,
+    display_signature_public_key,
+    display_signature,
+    display_entity_id,
+    display_entity_node,
+    display_entity_allowed,
+    display_context,
+    display_unknown,
+} display_kind_e;
+
+// Counts the items of the transaction that was read and where each group starts, nothing is formatted
+// Items: Type, the fee, the method's, the context. An entity shows ID, the nodes and Allowed
+__Z_INLINE void parser_buildPlan(parser_state_t *state) {
+    const parser_tx_t *tx = &state->tx;
+    display_plan_t *plan = &state->plan;
+    MEMZERO(plan, sizeof(display_plan_t));
+
+    // Type
+    uint16_t numItems = 1;
+
+    if (tx->type == entityType) {
+        plan->bodyStart = (uint8_t) numItems;
+        plan->nodesStart = (uint8_t) (numItems + 1);
+        numItems += 2 + tx->oasis.entity.nodes_length;
+    } else {
+        const oasis_tx_t *otx = &tx->oasis.tx;
+        if (otx->has_fee) {
+            numItems += 2;
+        }
+        plan->bodyStart = (uint8_t) numItems;
+
+        switch (otx->method) {
+            case stakingTransfer:
+            case stakingAddEscrow:
+            case stakingReclaimEscrow:
+                numItems += 2;
+                break;
+            case stakingBurn:
+            case registryUnfreezeNode:
+                numItems += 1;
+                break;
+            case stakingAmendCommissionSchedule:
+                // rates and bounds are limited by MAX_AMENDMENT_STEPS, this fits
+                numItems += 2 * otx->body.stakingAmendCommissionSchedule.rates_length;
+                plan->boundsStart = (uint8_t) numItems;
+                numItems += 3 * otx->body.stakingAmendCommissionSchedule.bounds_length;
+                break;
+            case registryRegisterEntity:
+                // Public key, Signature, then the entity
+                plan->nodesStart = (uint8_t) (numItems + 3);
+                numItems += 4 + otx->body.registryRegisterEntity.entity.nodes_length;
+                break;
+            case registryDeregisterEntity:
+            case unknownMethod:
+            default:
+                break;
+        }
+    }
 
-    for (uint8_t idx = 0; idx < numItems; idx++) {
-        uint8_t pageCount;
-        CHECK_PARSER_ERR(parser_getItem(ctx, idx, tmpKey, sizeof(tmpKey), tmpVal, sizeof(tmpVal), 0, &pageCount))
+    if (tx->context.suffixLen > 0) {
+        numItems++;
     }
 
-    return parser_ok;
+    plan->numItems = numItems > UINT8_MAX ? UINT8_MAX : (uint8_t) numItems;
 }
 
-uint8_t parser_getNumItems(const parser_context_t *ctx) {
-    uint8_t itemCount = _getNumItems(ctx, &parser_tx_obj);
-    if (parser_tx_obj.context.suffixLen > 0) {
-        itemCount++;
+__Z_INLINE display_kind_e parser_entityItemKind(const parser_state_t *state, uint8_t displayIdx, uint8_t *index) {
+    if (displayIdx < state->plan.nodesStart) {
+        return display_entity_id;
     }
-    return itemCount;
+    const uint8_t node = (uint8_t) (displayIdx - state->plan.nodesStart);
+    if (node < parser_entity(&state->tx)->nodes_length) {
+        *index = node;
+        return display_entity_node;
+    }
+    return display_entity_allowed;
 }
 
-__Z_INLINE parser_error_t parser_getType(const parser_context_t *ctx, char *outVal, uint16_t outValLen) {
-    switch (parser_tx_obj.oasis.tx.method) {
+// Kind of the item at displayIdx, index is set to its position in its group
+// displayIdx has to be below plan.numItems
+__Z_INLINE display_kind_e parser_itemKind(const parser_state_t *state, uint8_t displayIdx, uint8_t *index) {
+    const parser_tx_t *tx = &state->tx;
+    const display_plan_t *plan = &state->plan;
+    *index = 0;
+
+    if (displayIdx == 0) {
+        return display_type;
+    }
+    if (tx->context.suffixLen > 0 && displayIdx == plan->numItems - 1) {
+        return display_context;
+    }
+    if (tx->type == entityType) {
+        return parser_entityItemKind(state, displayIdx, index);
+    }
+    if (displayIdx < plan->bodyStart) {
+        return displayIdx == 1 ? display_fee_amount : display_fee_gas;
+    }
+
+    const uint8_t item = (uint8_t) (displayIdx - plan->bodyStart);
+    switch (tx->oasis.tx.method) {
         case stakingTransfer:
-            snprintf(outVal, outValLen, "Transfer");
-            return parser_ok;
+            return item == 0 ? display_transfer_to : display_transfer_tokens;
         case stakingBurn:
-            snprintf(outVal, outValLen, "Burn");
-            return parser_ok;
+            return display_burn_tokens;
         case stakingAddEscrow:
-            snprintf(outVal, outValLen, "Add escrow");
-            return parser_ok;
+            return item == 0 ? display_add_escrow_account : display_add_escrow_tokens;
         case stakingReclaimEscrow:
-            snprintf(outVal, outValLen, "Reclaim escrow");
-            return parser_ok;
+            return item == 0 ? display_reclaim_escrow_account : display_reclaim_escrow_shares;
         case stakingAmendCommissionSchedule:
-            snprintf(outVal, outValLen, "Amend commission schedule");
-            return parser_ok;
-        case registryDeregisterEntity:
-            snprintf(outVal, outValLen, "Deregister Entity");
-            return parser_ok;
+            if (displayIdx < plan->boundsStart) {
+                *index = item / 2;
+                return item % 2 == 0 ? display_rate_start : display_rate;
+            }
+            *index = (uint8_t) (displayIdx - plan->boundsStart) / 3;
+            return (display_kind_e) (display_bound_start + (displayIdx - plan->boundsStart) % 3);
         case registryUnfreezeNode:
-            snprintf(outVal, outValLen, "Unfreeze Node");
-            return parser_ok;
+            return display_unfreeze_node_id;
         case registryRegisterEntity:
-            snprintf(outVal, outValLen, "Register Entity");
-            return parser_ok;
+            if (item < 2) {
+                return item == 0 ? display_signature_public_key : display_signature;
+            }
+            return parser_entityItemKind(state, displayIdx, index);
+        case registryDeregisterEntity:
         case unknownMethod:
         default:
-            break;
+            return display_unknown;
     }
-    return parser_unexpected_method;
 }
 
-#define LESS_THAN_64_DIGIT(num_digit) if (num_digit > 64) return parser_value_out_of_range;
+// Amount shown by an item of one of the amount kinds
+__Z_INLINE const quantity_t *parser_amount(const oasis_tx_t *otx, display_kind_e kind) {
+    switch (kind) {
+        case display_fee_amount:
+            return &otx->fee_amount;
+        case display_transfer_tokens:
+            return &otx->body.stakingTransfer.xfer_tokens;
+        case display_burn_tokens:
+            return &otx->body.stakingBurn.burn_tokens;
+        case display_add_escrow_tokens:
+            return &otx->body.stakingAddEscrow.escrow_tokens;
+        case display_reclaim_escrow_shares:
+            return &otx->body.stakingReclaimEscrow.reclaim_shares;
+        default:
+            return NULL;
+    }
+}
 
-__Z_INLINE bool format_quantity(const quantity_t *q,
-                                uint8_t *bcd, uint16_t bcdSize,
-                                char *bignum, uint16_t bignumSize) {
+parser_error_t parser_state_parse(parser_state_t *state, const uint8_t *data, uint16_t dataLen) {
+    state->renderCache.valid = false;
+    state->plan.numItems = 0;
+    CHECK_PARSER_ERR(parser_init(&state->ctx, data, dataLen))
+    CHECK_PARSER_ERR(_readContext(&state->ctx, &state->tx))
+    CHECK_PARSER_ERR(_read(&state->ctx, &state->tx))
+    parser_buildPlan(state);
+    return parser_ok;
+}
 
-    bignumBigEndian_to_bcd(bcd, bcdSize, q->buffer, q->len);
-    return bignumBigEndian_bcdprint(bignum, bignumSize, bcd, bcdSize);
+parser_error_t parser_state_parseStream(parser_state_t *state,
+                                        const uint8_t *data,
+                                        uint16_t dataLen,
+                                        const parser_stream_t *stream) {
+    parser_context_t *ctx = &state->ctx;
+    state->renderCache.valid = false;
+    state->plan.numItems = 0;
+    CHECK_PARSER_ERR(parser_init(ctx, data, dataLen))
+    CHECK_PARSER_ERR(_readContext(ctx, &state->tx))
+    ctx->cborValidated = parser_stream_validated(stream, dataLen) && stream->cborStart == ctx->offset;
+    CHECK_PARSER_ERR(_read(ctx, &state->tx))
+    parser_buildPlan(state);
+    return parser_ok;
 }
 
+parser_error_t parser_state_validate(const parser_state_t *state) {
+    // Items are not rendered here, _validateTx checks they can be
+    CHECK_PARSER_ERR(_validateTx(&state->ctx, &state->tx))
+
+    // Display indexes are int8_t, items beyond that cannot be reached
+    if (state->plan.numItems > DISPLAY_PLAN_MAX_ITEMS) {
+        return parser_display_idx_out_of_range;
+    }
+
+    return parser_ok;
+}
+
+uint8_t parser_state_getNumItems(const parser_state_t *state) {
+    return state->plan.numItems;
+}
+
+// Value of the Type item of each method
+static const char *const methodNames[] = {
+        [unknownMethod] = NULL,
+        [stakingTransfer] = "Transfer",
+        [stakingBurn] = "Burn",
+        [stakingAddEscrow] = "Add escrow",
+        [stakingReclaimEscrow] = "Reclaim escrow",
+        [stakingAmendCommissionSchedule] = "Amend commission schedule",
+        [registryDeregisterEntity] = "Deregister Entity",
+        [registryUnfreezeNode] = "Unfreeze Node",
+        [registryRegisterEntity] = "Register Entity",
+};
+
+__Z_INLINE parser_error_t parser_getType(const parser_tx_t *tx, char *outVal, uint16_t outValLen) {
+    const oasis_methods_e method = tx->oasis.tx.method;
+    if ((size_t) method >= sizeof(methodNames) / sizeof(methodNames[0]) || methodNames[method] == NULL) {
+        return parser_unexpected_method;
+    }
+    fmt_copy(outVal, outValLen, (const char *) PIC(methodNames[method]));
+    return parser_ok;
+}
+
+#define LESS_THAN_64_DIGIT(num_digit) if (num_digit > 64) return parser_value_out_of_range;
+
 __Z_INLINE parser_error_t parser_printQuantity(const quantity_t *q,
                                                char *outVal, uint16_t outValLen,
                                                uint8_t pageIdx, uint8_t *pageCount) {
     // upperbound 2**(64*8)
-    // results in 155 decimal digits => max 78 bcd bytes
+    // results in 155 decimal digits
 
     // Too many digits, we cannot format this
     LESS_THAN_64_DIGIT(q->len)
 
-    char bignum[160];
-    union {
-        // overlapping arrays to avoid excessive stack usage. Do not use at the same time
-        uint8_t bcd[80];
-        char output[160];
-    } overlapped;
-
-    MEMZERO(overlapped.bcd, sizeof(overlapped.bcd));
-    MEMZERO(bignum, sizeof(bignum));
-
-    if (!format_quantity(q, overlapped.bcd, sizeof(overlapped.bcd), bignum, sizeof(bignum))) {
+    // Only the requested page is formatted
+    if (!bignumBigEndian_to_fpstr_page(outVal, outValLen, q->ptr, q->len,
+                                       COIN_AMOUNT_DECIMAL_PLACES, "", pageIdx, pageCount)) {
         return parser_unexpected_value;
     }
 
-    fpstr_to_str(overlapped.output, bignum, COIN_AMOUNT_DECIMAL_PLACES);
-    pageString(outVal, outValLen, overlapped.output, pageIdx, pageCount);
     return parser_ok;
 }
 
@@ -139,302 +321,337 @@ __Z_INLINE parser_error_t parser_printRate(const quantity_t *q,
     // Too many digits, we cannot format this
     LESS_THAN_64_DIGIT(q->len)
 
-    char bignum[160];
-    union {
-        // overlapping arrays to avoid excessive stack usage. Do not use at the same time
-        uint8_t bcd[80];
-        char output[160];
-    } overlapped;
-
-    MEMZERO(overlapped.bcd, sizeof(overlapped.bcd));
-    MEMZERO(bignum, sizeof(bignum));
-
-    if (!format_quantity(q, overlapped.bcd, sizeof(overlapped.bcd), bignum, sizeof(bignum))) {
+    if (!bignumBigEndian_to_fpstr_page(outVal, outValLen, q->ptr, q->len,
+                                       COIN_RATE_DECIMAL_PLACES - 2, "%", pageIdx, pageCount)) {
         return parser_unexpected_value;
     }
 
-    fpstr_to_str(overlapped.output, bignum, COIN_RATE_DECIMAL_PLACES - 2);
-    overlapped.output[strlen(overlapped.output)] = '%';
-    pageString(outVal, outValLen, overlapped.output, pageIdx, pageCount);
-
     return parser_ok;
 }
 
-__Z_INLINE parser_error_t parser_printPublicKey(const publickey_t *pk,
+__Z_INLINE parser_error_t parser_printPublicKey(render_cache_t *cache,
+                                                const publickey_t *pk,
                                                 char *outVal, uint16_t outValLen,
                                                 uint8_t pageIdx, uint8_t *pageCount) {
-    char outBuffer[128];
-    MEMZERO(outBuffer, sizeof(outBuffer));
+    char outBuffer[PUBLICKEY_DISPLAY_LEN + 1];
+    fmt_buffer_t f;
+    fmt_init(&f, outBuffer, sizeof(outBuffer));
 
-    bech32EncodeFromBytes(outBuffer, COIN_HRP, (uint8_t *) pk, sizeof(publickey_t));
-    pageString(outVal, outValLen, outBuffer, pageIdx, pageCount);
+    fmt_bech32(&f, COIN_HRP, COIN_HRP_STATE, pk->ptr);
+    parser_pageRendered(cache, outVal, outValLen, outBuffer, f.len, pageIdx, pageCount);
     return parser_ok;
 }
 
-__Z_INLINE parser_error_t parser_printSignature(raw_signature_t *s,
+__Z_INLINE parser_error_t parser_printSignature(render_cache_t *cache,
+                                                const raw_signature_t *s,
                                                 char *outVal, uint16_t outValLen,
                                                 uint8_t pageIdx, uint8_t *pageCount) {
+    // one more for the zero termination
+    char outBuffer[SIGNATURE_DISPLAY_LEN + 1];
+    fmt_buffer_t f;
+    fmt_init(&f, outBuffer, sizeof(outBuffer));
 
-    // 64 * 2 + 1 (one more for the zero termination)
-    char outBuffer[2 * sizeof(raw_signature_t) + 1];
-    MEMZERO(outBuffer, sizeof(outBuffer));
-
-    array_to_hexstr(outBuffer, (const uint8_t *) s, sizeof(raw_signature_t));
-    pageString(outVal, outValLen, outBuffer, pageIdx, pageCount);
+    fmt_hex(&f, s->ptr, RAW_SIGNATURE_LEN);
+    parser_pageRendered(cache, outVal, outValLen, outBuffer, f.len, pageIdx, pageCount);
     return parser_ok;
 }
 
-__Z_INLINE parser_error_t parser_getItemEntity(const oasis_entity_t *entity,
-                                               int8_t displayIdx,
-                                               char *outKey, uint16_t outKeyLen,
-                                               char *outVal, uint16_t outValLen,
-                                               uint8_t pageIdx, uint8_t *pageCount) {
-
-    if (displayIdx == 0) {
-        snprintf(outKey, outKeyLen, "ID");
-        return parser_printPublicKey(&entity->id,
-                                     outVal, outValLen, pageIdx, pageCount);
-    }
-
-    if (displayIdx <= (int) entity->nodes_length) {
-        const int8_t index = displayIdx - 1;
-
-        snprintf(outKey, outKeyLen, "Node [%i]", index);
-
-        publickey_t node;
-        CHECK_PARSER_ERR(_getEntityNodesIdAtIndex(entity, &node, index))
-        return parser_printPublicKey(&node, outVal, outValLen, pageIdx, pageCount);
-    }
-
-    if (displayIdx - entity->nodes_length == 1) {
-        snprintf(outKey, outKeyLen, "Allowed");
-        if (entity->allow_entity_signed_nodes) {
-            snprintf(outVal, outValLen, "True");
-        } else {
-            snprintf(outVal, outValLen, "False");
-        }
-        return parser_ok;
+// Keys of the items, keys with an index are split around it
+typedef struct {
+    const char *key;
+    const char *afterIndex;     // NULL if the key has no index
+} display_key_t;
+
+static const display_key_t displayKeys[] = {
+        [display_type] = {"Type", NULL},
+        [display_fee_amount] = {"Fee Amount", NULL},
+        [display_fee_gas] = {"Fee Gas", NULL},
+        [display_transfer_to] = {"To", NULL},
+        [display_transfer_tokens] = {"Tokens", NULL},
+        [display_burn_tokens] = {"Tokens", NULL},
+        [display_add_escrow_account] = {"Escrow", NULL},
+        [display_add_escrow_tokens] = {"Tokens", NULL},
+        [display_reclaim_escrow_account] = {"Escrow", NULL},
+        [display_reclaim_escrow_shares] = {"Tokens", NULL},
+        [display_rate_start] = {"Rates : [", "] start"},
+        [display_rate] = {"Rates : [", "] rate"},
+        [display_bound_start] = {"Bounds : [", "] start"},
+        [display_bound_min] = {"Bounds : [", "] min"},
+        [display_bound_max] = {"Bounds : [", "] max"},
+        [display_unfreeze_node_id] = {"Node ID", NULL},
+        [display_signature_public_key] = {"Public key", NULL},
+        [display_signature] = {"Signature", NULL},
+        [display_entity_id] = {"ID", NULL},
+        [display_entity_node] = {"Node [", "]"},
+        [display_entity_allowed] = {"Allowed", NULL},
+        [display_context] = {"Context", NULL},
+};
+
+__Z_INLINE void parser_printKey(char *outKey, uint16_t outKeyLen, display_kind_e kind, uint8_t index) {
+    const display_key_t *key = &displayKeys[kind];
+    fmt_buffer_t f;
+    fmt_init(&f, outKey, outKeyLen);
+    fmt_literal(&f, (const char *) PIC(key->key));
+    if (key->afterIndex != NULL) {
+        fmt_uint(&f, index);
+        fmt_literal(&f, (const char *) PIC(key->afterIndex));
     }
+}
 
-    return parser_no_data;
+__Z_INLINE void parser_printUint64(char *outVal, uint16_t outValLen, uint64_t value) {
+    fmt_buffer_t f;
+    fmt_init(&f, outVal, outValLen);
+    fmt_uint64(&f, value);
 }
 
-__Z_INLINE parser_error_t parser_getDynamicItem(const parser_context_t *ctx,
-                                                int8_t displayDynamicIdx,
+// Formats the item of the plan at displayIdx. Single page values leave pageCount at 1
+__Z_INLINE parser_error_t parser_getPlannedItem(parser_state_t *state,
+                                                int8_t displayIdx,
                                                 char *outKey, uint16_t outKeyLen,
                                                 char *outVal, uint16_t outValLen,
                                                 uint8_t pageIdx, uint8_t *pageCount) {
+    const parser_context_t *ctx = &state->ctx;
+    const parser_tx_t *tx = &state->tx;
+    const oasis_tx_t *otx = &tx->oasis.tx;
+    render_cache_t *cache = &state->renderCache;
+
+    uint8_t index;
+    const display_kind_e kind = parser_itemKind(state, (uint8_t) displayIdx, &index);
+    if (kind >= sizeof(displayKeys) / sizeof(displayKeys[0])) {
+        return parser_unexpected_type;
+    }
+    parser_printKey(outKey, outKeyLen, kind, index);
 
-    // Variable items
-    switch (parser_tx_obj.oasis.tx.method) {
-        case stakingTransfer:
-            switch (displayDynamicIdx) {
-                case 0: {
-                    snprintf(outKey, outKeyLen, "To");
-                    return parser_printPublicKey(&parser_tx_obj.oasis.tx.body.stakingTransfer.xfer_to,
-                                                 outVal, outValLen, pageIdx, pageCount);
-                }
-                case 1: {
-                    snprintf(outKey, outKeyLen, "Tokens");
-                    return parser_printQuantity(&parser_tx_obj.oasis.tx.body.stakingTransfer.xfer_tokens,
-                                                outVal, outValLen, pageIdx, pageCount);
-                }
-            }
-            break;
-        case stakingBurn:
-            switch (displayDynamicIdx) {
-                case 0: {
-                    snprintf(outKey, outKeyLen, "Tokens");
-                    return parser_printQuantity(&parser_tx_obj.oasis.tx.body.stakingBurn.burn_tokens,
-                                                outVal, outValLen, pageIdx, pageCount);
-                }
+    switch (kind) {
+        case display_type:
+            if (tx->type == entityType) {
+                fmt_copy(outVal, outValLen, "Entity signing");
+                return parser_ok;
             }
-            break;
-        case stakingAddEscrow:
-            switch (displayDynamicIdx) {
-                case 0: {
-                    snprintf(outKey, outKeyLen, "Escrow");
-                    return parser_printPublicKey(&parser_tx_obj.oasis.tx.body.stakingAddEscrow.escrow_account,
-                                                 outVal, outValLen, pageIdx, pageCount);
-                }
-                case 1: {
-                    snprintf(outKey, outKeyLen, "Tokens");
-                    return parser_printQuantity(&parser_tx_obj.oasis.tx.body.stakingAddEscrow.escrow_tokens,
-                                                outVal, outValLen, pageIdx, pageCount);
-                }
+            return parser_getType(tx, outVal, outValLen);
+        case display_fee_amount:
+        case display_transfer_tokens:
+        case display_burn_tokens:
+        case display_add_escrow_tokens:
+        case display_reclaim_escrow_shares:
+            return parser_printQuantity(parser_amount(otx, kind), outVal, outValLen, pageIdx, pageCount);
+        case display_fee_gas:
+            parser_printUint64(outVal, outValLen, otx->fee_gas);
+            return parser_ok;
+
+        case display_transfer_to:
+            return parser_printPublicKey(cache, &otx->body.stakingTransfer.xfer_to,
+                                         outVal, outValLen, pageIdx, pageCount);
+        case display_add_escrow_account:
+            return parser_printPublicKey(cache, &otx->body.stakingAddEscrow.escrow_account,
+                                         outVal, outValLen, pageIdx, pageCount);
+        case display_reclaim_escrow_account:
+            return parser_printPublicKey(cache, &otx->body.stakingReclaimEscrow.escrow_account,
+                                         outVal, outValLen, pageIdx, pageCount);
+
+        case display_rate_start:
+        case display_rate: {
+            commissionRateStep_t rate;
+            CHECK_PARSER_ERR(_getCommissionRateStepAtIndex(ctx, tx, &rate, index))
+
+            if (kind == display_rate_start) {
+                parser_printUint64(outVal, outValLen, rate.start);
+                return parser_ok;
             }
-            break;
-        case stakingReclaimEscrow:
-            switch (displayDynamicIdx) {
-                case 0: {
-                    snprintf(outKey, outKeyLen, "Escrow");
-                    return parser_printPublicKey(&parser_tx_obj.oasis.tx.body.stakingReclaimEscrow.escrow_account,
-                                                 outVal, outValLen, pageIdx, pageCount);
-                }
-                case 1: {
-                    snprintf(outKey, outKeyLen, "Tokens");
-                    return parser_printQuantity(&parser_tx_obj.oasis.tx.body.stakingReclaimEscrow.reclaim_shares,
-                                                outVal, outValLen, pageIdx, pageCount);
-                }
+            return parser_printRate(&rate.rate, outVal, outValLen, pageIdx, pageCount);
+        }
+        case display_bound_start:
+        case display_bound_min:
+        case display_bound_max: {
+            commissionRateBoundStep_t bound;
+            CHECK_PARSER_ERR(_getCommissionBoundStepAtIndex(ctx, tx, &bound, index))
+
+            if (kind == display_bound_start) {
+                parser_printUint64(outVal, outValLen, bound.start);
+                return parser_ok;
             }
-            break;
-        case stakingAmendCommissionSchedule:
-            if (displayDynamicIdx / 2 < (int) parser_tx_obj.oasis.tx.body.stakingAmendCommissionSchedule.rates_length) {
-                const int8_t index = displayDynamicIdx / 2;
-                commissionRateStep_t rate;
-
-                CHECK_PARSER_ERR(_getCommissionRateStepAtIndex(ctx, &rate, index))
-
-                switch (displayDynamicIdx % 2) {
-                    case 0: {
-                        snprintf(outKey, outKeyLen, "Rates : [%i] start", index);
-                        uint64_to_str(outVal, outValLen, rate.start);
-                        return parser_ok;
-                    }
-                    case 1: {
-                        snprintf(outKey, outKeyLen, "Rates : [%i] rate", index);
-                        return parser_printRate(&rate.rate, outVal, outValLen, pageIdx, pageCount);
-                    }
-                }
-            } else {
-                const int8_t index = (displayDynamicIdx -
-                                      parser_tx_obj.oasis.tx.body.stakingAmendCommissionSchedule.rates_length * 2) / 3;
-
-                // Only keeping one amendment in body at the time
-                commissionRateBoundStep_t bound;
-                CHECK_PARSER_ERR(_getCommissionBoundStepAtIndex(ctx, &bound, index))
-
-                switch ((displayDynamicIdx -
-                         parser_tx_obj.oasis.tx.body.stakingAmendCommissionSchedule.rates_length * 2) % 3) {
-                    case 0: {
-                        snprintf(outKey, outKeyLen, "Bounds : [%i] start", index);
-                        uint64_to_str(outVal, outValLen, bound.start);
-                        return parser_ok;
-                    }
-                    case 1: {
-                        snprintf(outKey, outKeyLen, "Bounds : [%i] min", index);
-                        return parser_printRate(&bound.rate_min, outVal, outValLen, pageIdx, pageCount);
-                    }
-                    case 2: {
-                        snprintf(outKey, outKeyLen, "Bounds : [%i] max", index);
-                        return parser_printRate(&bound.rate_max, outVal, outValLen, pageIdx, pageCount);
-                    }
-                }
+            if (kind == display_bound_min) {
+                return parser_printRate(&bound.rate_min, outVal, outValLen, pageIdx, pageCount);
             }
+            return parser_printRate(&bound.rate_max, outVal, outValLen, pageIdx, pageCount);
+        }
 
-            break;
-        case registryDeregisterEntity:
-            *pageCount = 0;
-            return parser_no_data;
-
-        case registryUnfreezeNode:
-            if (displayDynamicIdx == 0) {
-                snprintf(outKey, outKeyLen, "Node ID");
-                return parser_printPublicKey(&parser_tx_obj.oasis.tx.body.registryUnfreezeNode.node_id,
-                                             outVal, outValLen, pageIdx, pageCount);
-            }
-        case registryRegisterEntity: {
-            switch (displayDynamicIdx) {
-                case 0:
-                    snprintf(outKey, outKeyLen, "Public key");
-                    return parser_printPublicKey(
-                            &parser_tx_obj.oasis.tx.body.registryRegisterEntity.signature.public_key,
-                            outVal, outValLen, pageIdx, pageCount);
-                case 1:
-                    snprintf(outKey, outKeyLen, "Signature");
-                    return parser_printSignature(
-                            &parser_tx_obj.oasis.tx.body.registryRegisterEntity.signature.raw_signature,
-                            outVal, outValLen, pageIdx, pageCount);
-
-                default:
-                    return parser_getItemEntity(
-                            &parser_tx_obj.oasis.tx.body.registryRegisterEntity.entity,
-                            displayDynamicIdx - 2,
-                            outKey, outKeyLen, outVal, outValLen,
-                            pageIdx, pageCount);
-            }
+        case display_unfreeze_node_id:
+            return parser_printPublicKey(cache, &otx->body.registryUnfreezeNode.node_id,
+                                         outVal, outValLen, pageIdx, pageCount);
+        case display_signature_public_key:
+            return parser_printPublicKey(cache, &otx->body.registryRegisterEntity.signature.public_key,
+                                         outVal, outValLen, pageIdx, pageCount);
+        case display_signature:
+            return parser_printSignature(cache, &otx->body.registryRegisterEntity.signature.raw_signature,
+                                         outVal, outValLen, pageIdx, pageCount);
+
+        case display_entity_id:
+            return parser_printPublicKey(cache, &parser_entity(tx)->id, outVal, outValLen, pageIdx, pageCount);
+        case display_entity_node: {
+            publickey_t node;
+            CHECK_PARSER_ERR(_getEntityNodesIdAtIndex(parser_entity(tx), &node, index))
+            return parser_printPublicKey(cache, &node, outVal, outValLen, pageIdx, pageCount);
         }
-        case unknownMethod:
+        case display_entity_allowed:
+            fmt_copy(outVal, outValLen, parser_entity(tx)->allow_entity_signed_nodes ? "True" : "False");
+            return parser_ok;
+
+        case display_context:
+            pageStringExt(outVal, outValLen,
+                          (const char *) tx->context.suffixPtr, tx->context.suffixLen,
+                          pageIdx, pageCount);
+            return parser_ok;
+
         default:
-            break;
+            return parser_unexpected_type;
     }
-
-    *pageCount = 0;
-    return parser_no_data;
 }
 
-__Z_INLINE parser_error_t parser_getItemTx(const parser_context_t *ctx,
-                                           int8_t displayIdx,
-                                           char *outKey, uint16_t outKeyLen,
-                                           char *outVal, uint16_t outValLen,
-                                           uint8_t pageIdx, uint8_t *pageCount) {
+parser_error_t parser_state_getItem(parser_state_t *state,
+                                   int8_t displayIdx,
+                                   char *outKey, uint16_t outKeyLen,
+                                   char *outVal, uint16_t outValLen,
+                                   uint8_t pageIdx, uint8_t *pageCount) {
+    render_cache_t *cache = &state->renderCache;
 
-    if (displayIdx == 0) {
-        snprintf(outKey, outKeyLen, "Type");
-        return parser_getType(ctx, outVal, outValLen);
-    }
+    MEMZERO(outKey, outKeyLen);
+    MEMZERO(outVal, outValLen);
+    fmt_copy(outKey, outKeyLen, "?");
+    fmt_copy(outVal, outValLen, " ");
+    *pageCount = 1;
 
-    if (displayIdx == 1 && parser_tx_obj.oasis.tx.has_fee) {
-        snprintf(outKey, outKeyLen, "Fee Amount");
-        return parser_printQuantity(&parser_tx_obj.oasis.tx.fee_amount, outVal, outValLen, pageIdx, pageCount);
+    if (displayIdx < 0 || displayIdx >= state->plan.numItems) {
+        return parser_no_data;
     }
 
-    if (displayIdx == 2 && parser_tx_obj.oasis.tx.has_fee) {
-        snprintf(outKey, outKeyLen, "Fee Gas");
-        uint64_to_str(outVal, outValLen, parser_tx_obj.oasis.tx.fee_gas);
+    if (cache->valid && cache->displayIdx == displayIdx) {
+        fmt_copy(outKey, outKeyLen, cache->key);
+        pageString(outVal, outValLen, cache->value, pageIdx, pageCount);
         return parser_ok;
     }
 
-    uint8_t numberFixedItems = 3;
-    if (!parser_tx_obj.oasis.tx.has_fee)
-        numberFixedItems = 1;
+    cache->valid = false;
+    cache->pending = false;
+
+    const parser_error_t err = parser_getPlannedItem(state, displayIdx,
+                                                     outKey, outKeyLen, outVal, outValLen,
+                                                     pageIdx, pageCount);
 
-    // Now display dynamic items
-    const int8_t displayDynIdx = displayIdx - numberFixedItems;
-    return parser_getDynamicItem(ctx, displayDynIdx, outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
+    // Only values formatted through parser_pageRendered are kept
+    if (err == parser_ok && cache->pending && strlen(outKey) < sizeof(cache->key)) {
+        fmt_copy(cache->key, sizeof(cache->key), outKey);
+        cache->displayIdx = displayIdx;
+        cache->valid = true;
+    }
+
+    return err;
 }
 
-parser_error_t parser_getItem(const parser_context_t *ctx,
-                              int8_t displayIdx,
-                              char *outKey, uint16_t outKeyLen,
-                              char *outVal, uint16_t outValLen,
-                              uint8_t pageIdx, uint8_t *pageCount) {
-    MEMZERO(outKey, outKeyLen);
-    MEMZERO(outVal, outValLen);
-    snprintf(outKey, outKeyLen, "?");
-    snprintf(outVal, outValLen, " ");
+// Same paging as pageStringExt
+__Z_INLINE uint8_t parser_pages(uint16_t valueLen, uint16_t outValueLen) {
+    if (outValueLen < 2 || valueLen == 0) {
+        return 1;
+    }
+    outValueLen--;
+    return (uint8_t) ((valueLen + outValueLen - 1) / outValueLen);
+}
 
-    if (displayIdx < 0 || displayIdx >= parser_getNumItems(ctx)) {
-        return parser_no_data;
+// Length of the rate shown by a rate or bound item, 0 if it cannot be decoded
+__Z_INLINE uint8_t parser_rateLen(const parser_state_t *state, display_kind_e kind, uint8_t index) {
+    if (kind == display_rate) {
+        commissionRateStep_t rate;
+        if (_getCommissionRateStepAtIndex(&state->ctx, &state->tx, &rate, index) != parser_ok) {
+            return 0;
+        }
+        return RATE_LEN(&rate.rate);
     }
 
-    if (parser_tx_obj.context.suffixLen > 0 && displayIdx + 1 == parser_getNumItems(ctx) /*last*/) {
-        // Display context
-        snprintf(outKey, outKeyLen, "Context");
-        pageStringExt(outVal, outValLen,
-                      (const char *) parser_tx_obj.context.suffixPtr, parser_tx_obj.context.suffixLen,
-                      pageIdx, pageCount);
-        return parser_ok;
+    commissionRateBoundStep_t bound;
+    if (_getCommissionBoundStepAtIndex(&state->ctx, &state->tx, &bound, index) != parser_ok) {
+        return 0;
     }
+    return RATE_LEN(kind == display_bound_min ? &bound.rate_min : &bound.rate_max);
+}
 
-    switch (parser_tx_obj.type) {
-        case txType:
-            return parser_getItemTx(ctx,
-                                    displayIdx,
-                                    outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
-        case entityType: {
-            if (displayIdx == 0) {
-                snprintf(outKey, outKeyLen, "Type");
-                snprintf(outVal, outValLen, "Entity signing");
-                return parser_ok;
-            }
+uint8_t parser_state_getItemPageCount(const parser_state_t *state, int8_t displayIdx, uint16_t outValueLen) {
+    if (displayIdx < 0 || displayIdx >= state->plan.numItems) {
+        return 0;
+    }
 
-            return parser_getItemEntity(&parser_tx_obj.oasis.entity,
-                                        displayIdx - 1,
-                                        outKey, outKeyLen, outVal, outValLen, pageIdx, pageCount);
-        }
+    uint8_t index;
+    const display_kind_e kind = parser_itemKind(state, (uint8_t) displayIdx, &index);
+    switch (kind) {
+        case display_fee_amount:
+        case display_transfer_tokens:
+        case display_burn_tokens:
+        case display_add_escrow_tokens:
+        case display_reclaim_escrow_shares:
+            return parser_pages(AMOUNT_LEN(parser_amount(&state->tx.oasis.tx, kind)), outValueLen);
+
+        case display_rate:
+        case display_bound_min:
+        case display_bound_max:
+            return parser_pages(parser_rateLen(state, kind, index), outValueLen);
+
+        case display_transfer_to:
+        case display_add_escrow_account:
+        case display_reclaim_escrow_account:
+        case display_unfreeze_node_id:
+        case display_signature_public_key:
+        case display_entity_id:
+        case display_entity_node:
+            return parser_pages(PUBLICKEY_DISPLAY_LEN, outValueLen);
+        case display_signature:
+            return parser_pages(SIGNATURE_DISPLAY_LEN, outValueLen);
+        case display_context:
+            return parser_pages(state->tx.context.suffixLen, outValueLen);
 
         default:
-            return parser_unexpected_type;
+            return 1;
     }
 }
+
+// The context is owned by the caller: it is copied to the state when the transaction
+// is parsed and back before each call, so these behave as the functions with a state
+
+parser_error_t parser_parse(parser_context_t *ctx, const uint8_t *data, uint16_t dataLen) {
+    const parser_error_t err = parser_state_parse(&parser_state, data, dataLen);
+    *ctx = parser_state.ctx;
+    return err;
+}
+
+parser_error_t parser_parseStream(parser_context_t *ctx,
+                                  const uint8_t *data,
+                                  uint16_t dataLen,
+                                  const parser_stream_t *stream) {
+    const parser_error_t err = parser_state_parseStream(&parser_state, data, dataLen, stream);
+    *ctx = parser_state.ctx;
+    return err;
+}
+
+parser_error_t parser_validate(const parser_context_t *ctx) {
+    parser_state.ctx = *ctx;
+    return parser_state_validate(&parser_state);
+}
+
+uint8_t parser_getNumItems(const parser_context_t *ctx) {
+    parser_state.ctx = *ctx;
+    return parser_state_getNumItems(&parser_state);
+}
+
+parser_error_t parser_getItem(const parser_context_t *ctx,
+                              int8_t displayIdx,
+                              char *outKey, uint16_t outKeyLen,
+                              char *outVal, uint16_t outValLen,
+                              uint8_t pageIdx, uint8_t *pageCount) {
+    parser_state.ctx = *ctx;
+    return parser_state_getItem(&parser_state, displayIdx,
+                                outKey, outKeyLen, outVal, outValLen,
+                                pageIdx, pageCount);
+}
+
+uint8_t parser_getItemPageCount(const parser_context_t *ctx, int8_t displayIdx, uint16_t outValueLen) {
+    parser_state.ctx = *ctx;
+    return parser_state_getItemPageCount(&parser_state, displayIdx, outValueLen);
+}
@@ -21,15 +21,92 @@ extern "C" {
 #endif
 
 #include "parser_impl.h"
+#include "parser_stream.h"
 #include "hexutils.h"
 
+// Keeps the last fully formatted value so paging within an item does not format it again
+#if defined(TARGET_NANOS)
+#define RENDER_CACHE_VALUE_SIZE 96
+#else
+#define RENDER_CACHE_VALUE_SIZE 160
+#endif
+#define RENDER_CACHE_KEY_SIZE 32
+
+typedef struct {
+    bool valid;
+    bool pending;
+    int8_t displayIdx;
+    char key[RENDER_CACHE_KEY_SIZE];
+    char value[RENDER_CACHE_VALUE_SIZE];
+} render_cache_t;
+
+// Display indexes are int8_t, a transaction with more items is rejected by parser_validate
+#define DISPLAY_PLAN_MAX_ITEMS      (INT8_MAX + 1)
+
+// Where the groups of items of the parsed transaction start, built by parser_state_parse
+// The kind of an item and its index in its group are worked out from these and the transaction
+typedef struct {
+    uint8_t numItems;           // can be above DISPLAY_PLAN_MAX_ITEMS
+    uint8_t bodyStart;          // first item of the method, after the type and the fee
+    uint8_t boundsStart;
+    uint8_t nodesStart;
+} display_plan_t;
+
+// Everything the parser keeps about one transaction
+// Functions that take a state only touch that state, so several can be used from different threads
+typedef struct {
+    parser_context_t ctx;
+    parser_tx_t tx;
+    display_plan_t plan;
+    render_cache_t renderCache;
+} parser_state_t;
+
 const char *parser_getErrorDescription(parser_error_t err);
 
+//// parses a tx buffer into state
+//// the buffer is referenced by the state and has to outlive it
+parser_error_t parser_state_parse(parser_state_t *state,
+                                  const uint8_t *data,
+                                  uint16_t dataLen);
+
+//// parses a tx buffer that was scanned by parser_stream_feed as it was received
+//// results are the same as parser_state_parse, canonical CBOR checks are skipped if the stream validated them
+parser_error_t parser_state_parseStream(parser_state_t *state,
+                                        const uint8_t *data,
+                                        uint16_t dataLen,
+                                        const parser_stream_t *stream);
+
+//// verifies tx fields
+parser_error_t parser_state_validate(const parser_state_t *state);
+
+//// returns the number of items of the parsed transaction
+uint8_t parser_state_getNumItems(const parser_state_t *state);
+
+//// retrieves a readable output for each field / page
+//// state is updated: it keeps the last formatted value for the next pages
+parser_error_t parser_state_getItem(parser_state_t *state,
+                                    int8_t displayIdx,
+                                    char *outKey, uint16_t outKeyLen,
+                                    char *outValue, uint16_t outValueLen,
+                                    uint8_t pageIdx, uint8_t *pageCount);
+
+//// number of pages of an item, without formatting it
+//// the same pageCount parser_state_getItem returns for outValueLen, 0 if there is no such item
+uint8_t parser_state_getItemPageCount(const parser_state_t *state, int8_t displayIdx, uint16_t outValueLen);
+
+// The functions below share a single global state, they are the ones the firmware uses
+
 //// parses a tx buffer
 parser_error_t parser_parse(parser_context_t *ctx,
                             const uint8_t *data,
                             uint16_t dataLen);
 
+//// parses a tx buffer that was scanned by parser_stream_feed as it was received
+parser_error_t parser_parseStream(parser_context_t *ctx,
+                                  const uint8_t *data,
+                                  uint16_t dataLen,
+                                  const parser_stream_t *stream);
+
 //// verifies tx fields
 parser_error_t parser_validate(const parser_context_t *ctx);
 
@@ -43,6 +120,8 @@ parser_error_t parser_getItem(const parser_context_t *ctx,
                               char *outValue, uint16_t outValueLen,
                               uint8_t pageIdx, uint8_t *pageCount);
 
+uint8_t parser_getItemPageCount(const parser_context_t *ctx, int8_t displayIdx, uint16_t outValueLen);
+
 #ifdef __cplusplus
 }
 #endif
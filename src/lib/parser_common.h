@@ -21,8 +21,9 @@ extern "C" {
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
-#define CHECK_PARSER_ERR(err) {if (err!=parser_ok) return err;}
+#define CHECK_PARSER_ERR(CALL) {parser_error_t __err = CALL; if (__err!=parser_ok) return __err;}
 
 typedef enum {
     // Generic errors
@@ -52,12 +53,17 @@ typedef enum {
     // Required fields
     parser_required_nonce,
     parser_required_method,
+    // Batch related errors
+    parser_batch_empty,
+    parser_batch_too_many_tx,
 } parser_error_t;
 
 typedef struct {
     const uint8_t *buffer;
     uint16_t bufferLen;
     uint16_t offset;
+    // CBOR was already validated as canonical while the buffer was received
+    bool cborValidated;
 } parser_context_t;
 
 #ifdef __cplusplus
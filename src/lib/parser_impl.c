@@ -19,7 +19,6 @@
 #include "parser_txdef.h"
 #include "cbor_helper.h"
 
-parser_tx_t parser_tx_obj;
 const char context_prefix_tx[] = "oasis-core/consensus: tx for chain ";
 const char context_prefix_entity[] = "oasis-core/registry: register entity";
 
@@ -27,6 +26,7 @@ parser_error_t parser_init_context(parser_context_t *ctx,
                                    const uint8_t *buffer,
                                    uint16_t bufferSize) {
     ctx->offset = 0;
+    ctx->cborValidated = false;
 
     if (bufferSize == 0 || buffer == NULL) {
         // Not available, use defaults
@@ -98,6 +98,11 @@ const char *parser_getErrorDescription(parser_error_t err) {
             return "Required field nonce";
         case parser_required_method:
             return "Required field method";
+            // Batch related errors
+        case parser_batch_empty:
+            return "Empty batch";
+        case parser_batch_too_many_tx:
+            return "Too many transactions in batch";
         default:
             return "Unrecognized error code";
     }
@@ -112,32 +117,40 @@ void parser_setCborState(cbor_parser_state_t *state, const CborParser *parser, c
     }
 }
 
-__Z_INLINE parser_error_t _readPublicKey(CborValue *value, publickey_t *out) {
+// Byte strings are not copied: ptr points to them in the buffer
+__Z_INLINE parser_error_t _readBytes(CborValue *value, const uint8_t **ptr, size_t *len) {
     CHECK_CBOR_TYPE(cbor_value_get_type(value), CborByteStringType)
-    CborValue dummy;
-    size_t len = sizeof(publickey_t);
-    CHECK_CBOR_ERR(cbor_value_copy_byte_string(value, (uint8_t *) out, &len, &dummy))
-    if (len != sizeof(publickey_t)) {
+    CHECK_CBOR_CANONICAL(value)
+    // Only a single chunk can be read in place
+    CHECK_CBOR_ERR(cbor_value_get_string_length(value, len))
+    CborValue chunk = *value;
+    CHECK_CBOR_ERR(get_string_chunk(&chunk, (const void **) ptr, len))
+    return parser_ok;
+}
+
+__Z_INLINE parser_error_t _readPublicKey(CborValue *value, publickey_t *out) {
+    size_t len;
+    CHECK_PARSER_ERR(_readBytes(value, &out->ptr, &len))
+    if (len != PUBLICKEY_LEN) {
         return parser_unexpected_value;
     }
     return parser_ok;
 }
 
 __Z_INLINE parser_error_t _readQuantity(CborValue *value, quantity_t *out) {
-    CHECK_CBOR_TYPE(cbor_value_get_type(value), CborByteStringType)
-    CborValue dummy;
-    MEMZERO(out, sizeof(quantity_t));
-    out->len = sizeof_field(quantity_t, buffer);
-    CHECK_CBOR_ERR(cbor_value_copy_byte_string(value, (uint8_t *) out->buffer, &out->len, &dummy))
+    size_t len;
+    CHECK_PARSER_ERR(_readBytes(value, &out->ptr, &len))
+    if (len > QUANTITY_MAX_LEN) {
+        return parser_value_out_of_range;
+    }
+    out->len = (uint8_t) len;
     return parser_ok;
 }
 
 __Z_INLINE parser_error_t _readRawSignature(CborValue *value, raw_signature_t *out) {
-    CHECK_CBOR_TYPE(cbor_value_get_type(value), CborByteStringType)
-    CborValue dummy;
-    size_t len = sizeof(raw_signature_t);
-    CHECK_CBOR_ERR(cbor_value_copy_byte_string(value, (uint8_t *) out, &len, &dummy))
-    if (len != sizeof(raw_signature_t)) {
+    size_t len;
+    CHECK_PARSER_ERR(_readBytes(value, &out->ptr, &len))
+    if (len != RAW_SIGNATURE_LEN) {
         return parser_unexpected_value;
     }
     return parser_ok;
@@ -154,13 +167,11 @@ __Z_INLINE parser_error_t _readSignature(CborValue *value, signature_t *out) {
     CHECK_CBOR_MAP_LEN(value, 2)
     CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "signature"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "signature"))
     CHECK_PARSER_ERR(_readRawSignature(&contents, &out->raw_signature))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "public_key"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "public_key"))
     CHECK_PARSER_ERR(_readPublicKey(&contents, &out->public_key))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
@@ -180,14 +191,13 @@ __Z_INLINE parser_error_t _readRate(CborValue *value, commissionRateStep_t *out)
     CHECK_CBOR_MAP_LEN(value, 2)
     CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "rate"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "rate"))
     CHECK_PARSER_ERR(_readQuantity(&contents, &out->rate))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "start"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "start"))
     CHECK_CBOR_TYPE(cbor_value_get_type(&contents), CborIntegerType)
+    CHECK_CBOR_CANONICAL(&contents)
     CHECK_CBOR_ERR(cbor_value_get_uint64(&contents, &out->start))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
@@ -208,26 +218,24 @@ __Z_INLINE parser_error_t _readBound(CborValue *value, commissionRateBoundStep_t
     CHECK_CBOR_MAP_LEN(value, 3)
     CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "start"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "start"))
     CHECK_CBOR_TYPE(cbor_value_get_type(&contents), CborIntegerType)
+    CHECK_CBOR_CANONICAL(&contents)
     CHECK_CBOR_ERR(cbor_value_get_uint64(&contents, &out->start))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "rate_max"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "rate_max"))
     CHECK_PARSER_ERR(_readQuantity(&contents, &out->rate_max))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "rate_min"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "rate_min"))
     CHECK_PARSER_ERR(_readQuantity(&contents, &out->rate_min))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
     return parser_ok;
 }
 
-__Z_INLINE parser_error_t _readAmendment(parser_tx_t *v, CborValue *value) {
+__Z_INLINE parser_error_t _readAmendment(const parser_context_t *c, parser_tx_t *v, CborValue *value) {
 //  {
 //    "rates": [
 //     ...
@@ -239,25 +247,55 @@ __Z_INLINE parser_error_t _readAmendment(parser_tx_t *v, CborValue *value) {
 
     /// Enter container
     CborValue contents;
+    CborValue arrayContents;
     CHECK_CBOR_TYPE(cbor_value_get_type(value), CborMapType)
     CHECK_CBOR_MAP_LEN(value, 2)
     CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "rates"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "rates"))
     CHECK_CBOR_TYPE(cbor_value_get_type(&contents), CborArrayType)
+    CHECK_CBOR_CANONICAL(&contents)
 
     // Array of rates
-    cbor_value_get_array_length(&contents, &v->oasis.tx.body.stakingAmendCommissionSchedule.rates_length);
+    size_t ratesLength;
+    CHECK_CBOR_ERR(cbor_value_get_array_length(&contents, &ratesLength))
+    if (ratesLength > MAX_AMENDMENT_STEPS) {
+        return parser_unexpected_number_items;
+    }
+    v->oasis.tx.body.stakingAmendCommissionSchedule.rates_length = (uint8_t) ratesLength;
 
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    // Keep the offset of each rate so they can be read on demand without walking the array again
+    CHECK_CBOR_ERR(cbor_value_enter_container(&contents, &arrayContents))
+    for (size_t i = 0; i < ratesLength; i++) {
+        commissionRateStep_t rate;
+        v->oasis.tx.body.stakingAmendCommissionSchedule.steps_offset[i] =
+                (uint16_t) (arrayContents.ptr - c->buffer);
+        CHECK_PARSER_ERR(_readRate(&arrayContents, &rate))
+        CHECK_CBOR_ERR(cbor_value_advance(&arrayContents))
+    }
+    CHECK_CBOR_ERR(cbor_value_leave_container(&contents, &arrayContents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "bounds"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "bounds"))
     CHECK_CBOR_TYPE(cbor_value_get_type(&contents), CborArrayType)
+    CHECK_CBOR_CANONICAL(&contents)
 
     // Array of bounds
-    cbor_value_get_array_length(&contents, &v->oasis.tx.body.stakingAmendCommissionSchedule.bounds_length);
+    size_t boundsLength;
+    CHECK_CBOR_ERR(cbor_value_get_array_length(&contents, &boundsLength))
+    if (boundsLength > MAX_AMENDMENT_STEPS - ratesLength) {
+        return parser_unexpected_number_items;
+    }
+    v->oasis.tx.body.stakingAmendCommissionSchedule.bounds_length = (uint8_t) boundsLength;
+
+    CHECK_CBOR_ERR(cbor_value_enter_container(&contents, &arrayContents))
+    for (size_t i = 0; i < boundsLength; i++) {
+        commissionRateBoundStep_t bound;
+        v->oasis.tx.body.stakingAmendCommissionSchedule.steps_offset[ratesLength + i] =
+                (uint16_t) (arrayContents.ptr - c->buffer);
+        CHECK_PARSER_ERR(_readBound(&arrayContents, &bound))
+        CHECK_CBOR_ERR(cbor_value_advance(&arrayContents))
+    }
+    CHECK_CBOR_ERR(cbor_value_leave_container(&contents, &arrayContents))
 
     return parser_ok;
 }
@@ -274,14 +312,13 @@ __Z_INLINE parser_error_t _readFee(parser_tx_t *v, CborValue *value) {
     CHECK_CBOR_MAP_LEN(value, 2)
     CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "gas"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "gas"))
     CHECK_CBOR_TYPE(cbor_value_get_type(&contents), CborIntegerType)
+    CHECK_CBOR_CANONICAL(&contents)
     CHECK_CBOR_ERR(cbor_value_get_uint64(&contents, &v->oasis.tx.fee_gas))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "amount"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "amount"))
     CHECK_PARSER_ERR(_readQuantity(&contents, &v->oasis.tx.fee_amount))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
@@ -303,16 +340,18 @@ __Z_INLINE parser_error_t _readEntity(oasis_entity_t *entity) {
     CHECK_CBOR_MAP_LEN(&value, 3)
     CHECK_CBOR_ERR(cbor_value_enter_container(&value, &contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "id"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "id"))
     CHECK_PARSER_ERR(_readPublicKey(&contents, &entity->id))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "nodes"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "nodes"))
     // Only get length
     CHECK_CBOR_TYPE(cbor_value_get_type(&contents), CborArrayType)
     cbor_value_get_array_length(&contents, &entity->nodes_length);
+    // Nodes are read on demand, so this is the only time they are visited while parsing
+    if (!CBOR_IS_VALIDATED(&contents)) {
+        CHECK_CBOR_ERR(cbor_value_validate(&contents, contents.parser->flags))
+    }
 
     // too many node ids in the blob to be printed
     if (entity->nodes_length > MAX_ENTITY_NODES) {
@@ -321,8 +360,7 @@ __Z_INLINE parser_error_t _readEntity(oasis_entity_t *entity) {
 
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-    CHECK_PARSER_ERR(_matchKey(&contents, "allow_entity_signed_nodes"))
-    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    CHECK_PARSER_ERR(_seekKey(&contents, "allow_entity_signed_nodes"))
     CHECK_CBOR_TYPE(cbor_value_get_type(&contents), CborBooleanType)
     CHECK_CBOR_ERR(cbor_value_get_boolean(&contents, &entity->allow_entity_signed_nodes))
     CHECK_CBOR_ERR(cbor_value_advance(&contents))
@@ -330,7 +368,7 @@ __Z_INLINE parser_error_t _readEntity(oasis_entity_t *entity) {
     return parser_ok;
 }
 
-__Z_INLINE parser_error_t _readBody(parser_tx_t *v, CborValue *value) {
+__Z_INLINE parser_error_t _readBody(const parser_context_t *c, parser_tx_t *v, CborValue *value) {
     // Reference: https://github.com/oasislabs/oasis-core/blob/kostko/feature/docs-staking/docs/consensus/staking.md#test-vectors
 
     CborValue contents;
@@ -341,13 +379,11 @@ __Z_INLINE parser_error_t _readBody(parser_tx_t *v, CborValue *value) {
             CHECK_CBOR_MAP_LEN(value, 2)
             CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "xfer_to"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "xfer_to"))
             CHECK_PARSER_ERR(_readPublicKey(&contents, &v->oasis.tx.body.stakingTransfer.xfer_to))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "xfer_tokens"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "xfer_tokens"))
             CHECK_PARSER_ERR(_readQuantity(&contents, &v->oasis.tx.body.stakingTransfer.xfer_tokens))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
             break;
@@ -356,8 +392,7 @@ __Z_INLINE parser_error_t _readBody(parser_tx_t *v, CborValue *value) {
             CHECK_CBOR_MAP_LEN(value, 1)
             CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "burn_tokens"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "burn_tokens"))
             CHECK_PARSER_ERR(_readQuantity(&contents, &v->oasis.tx.body.stakingBurn.burn_tokens))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
             break;
@@ -366,13 +401,11 @@ __Z_INLINE parser_error_t _readBody(parser_tx_t *v, CborValue *value) {
             CHECK_CBOR_MAP_LEN(value, 2)
             CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "escrow_tokens"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "escrow_tokens"))
             CHECK_PARSER_ERR(_readQuantity(&contents, &v->oasis.tx.body.stakingAddEscrow.escrow_tokens))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "escrow_account"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "escrow_account"))
             CHECK_PARSER_ERR(_readPublicKey(&contents, &v->oasis.tx.body.stakingAddEscrow.escrow_account))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
             break;
@@ -381,13 +414,11 @@ __Z_INLINE parser_error_t _readBody(parser_tx_t *v, CborValue *value) {
             CHECK_CBOR_MAP_LEN(value, 2)
             CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "escrow_account"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "escrow_account"))
             CHECK_PARSER_ERR(_readPublicKey(&contents, &v->oasis.tx.body.stakingReclaimEscrow.escrow_account))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "reclaim_shares"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "reclaim_shares"))
             CHECK_PARSER_ERR(_readQuantity(&contents, &v->oasis.tx.body.stakingReclaimEscrow.reclaim_shares))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
             break;
@@ -396,10 +427,9 @@ __Z_INLINE parser_error_t _readBody(parser_tx_t *v, CborValue *value) {
             CHECK_CBOR_MAP_LEN(value, 1)
             CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "amendment"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
-            // ONLY READ LENGTH ! THEN GET ON ITEM ON DEMAND
-            CHECK_PARSER_ERR(_readAmendment(v, &contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "amendment"))
+            // ONLY INDEX ITEMS ! THEN GET ON ITEM ON DEMAND
+            CHECK_PARSER_ERR(_readAmendment(c, v, &contents))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
             break;
@@ -408,8 +438,7 @@ __Z_INLINE parser_error_t _readBody(parser_tx_t *v, CborValue *value) {
             CHECK_CBOR_MAP_LEN(value, 1)
             CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "node_id"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "node_id"))
             CHECK_PARSER_ERR(_readPublicKey(&contents, &v->oasis.tx.body.registryUnfreezeNode.node_id))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
@@ -419,20 +448,20 @@ __Z_INLINE parser_error_t _readBody(parser_tx_t *v, CborValue *value) {
             CHECK_CBOR_MAP_LEN(value, 2)
             CHECK_CBOR_ERR(cbor_value_enter_container(value, &contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "signature"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "signature"))
             // Read signature
             CHECK_PARSER_ERR(_readSignature(&contents, &v->oasis.tx.body.registryRegisterEntity.signature))
             CHECK_CBOR_ERR(cbor_value_advance(&contents))
 
-            CHECK_PARSER_ERR(_matchKey(&contents, "untrusted_raw_value"))
-            CHECK_CBOR_ERR(cbor_value_advance(&contents))
+            CHECK_PARSER_ERR(_seekKey(&contents, "untrusted_raw_value"))
 
             if (!cbor_value_is_byte_string(&contents)) {
                 return parser_unexpected_type;
             }
+            CHECK_CBOR_CANONICAL(&contents)
 
             // We create new Cbor parser with the byte string
+            // The entity blob is opaque to the transaction, so it is not required to be canonical
             const uint8_t *buffer;
             size_t buffer_size;
 
@@ -460,46 +489,67 @@ __Z_INLINE parser_error_t _readNonce(parser_tx_t *v, CborValue *value) {
         return parser_required_nonce;
 
     CHECK_CBOR_TYPE(cbor_value_get_type(value), CborIntegerType)
+    CHECK_CBOR_CANONICAL(value)
     CHECK_CBOR_ERR(cbor_value_get_uint64(value, &v->oasis.tx.nonce))
 
     return parser_ok;
 }
 
+typedef struct {
+    const char *name;
+    uint8_t len;
+    oasis_methods_e method;
+} method_entry_t;
+
+// Sorted by name length, so a lookup only compares names of the same length
+// New methods can be added anywhere as long as the order is kept
+static const method_entry_t methods[] = {
+        {"staking.Burn", 12, stakingBurn},
+        {"staking.Transfer", 16, stakingTransfer},
+        {"staking.AddEscrow", 17, stakingAddEscrow},
+        {"staking.ReclaimEscrow", 21, stakingReclaimEscrow},
+        {"registry.UnfreezeNode", 21, registryUnfreezeNode},
+        {"registry.RegisterEntity", 23, registryRegisterEntity},
+        {"registry.DeregisterEntity", 25, registryDeregisterEntity},
+        {"staking.AmendCommissionSchedule", 31, stakingAmendCommissionSchedule},
+};
+
+__Z_INLINE oasis_methods_e _lookupMethod(const char *name, size_t len) {
+    for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        if (methods[i].len < len) {
+            continue;
+        }
+        if (methods[i].len > len) {
+            break;
+        }
+        if (MEMCMP(PIC(methods[i].name), name, len) == 0) {
+            return methods[i].method;
+        }
+    }
+    return unknownMethod;
+}
+
 __Z_INLINE parser_error_t _readMethod(parser_tx_t *v, CborValue *value) {
 
     if (!cbor_value_is_valid(value))
         return parser_required_method;
 
     // Verify it is well formed (no missing bytes...)
-    CHECK_CBOR_ERR(cbor_value_validate_basic(value))
+    CHECK_CBOR_CANONICAL(value)
 
     v->oasis.tx.method = unknownMethod;
 
-    if (CBOR_KEY_MATCHES(value, "staking.Transfer")) {
-        v->oasis.tx.method = stakingTransfer;
-    }
-    if (CBOR_KEY_MATCHES(value, "staking.Burn")) {
-        v->oasis.tx.method = stakingBurn;
-    }
-    if (CBOR_KEY_MATCHES(value, "staking.AddEscrow")) {
-        v->oasis.tx.method = stakingAddEscrow;
-    }
-    if (CBOR_KEY_MATCHES(value, "staking.ReclaimEscrow")) {
-        v->oasis.tx.method = stakingReclaimEscrow;
-    }
-    if (CBOR_KEY_MATCHES(value, "staking.AmendCommissionSchedule")) {
-        v->oasis.tx.method = stakingAmendCommissionSchedule;
-    }
-    if (CBOR_KEY_MATCHES(value, "registry.DeregisterEntity")) {
-        v->oasis.tx.method = registryDeregisterEntity;
-    }
-    if (CBOR_KEY_MATCHES(value, "registry.UnfreezeNode")) {
-        v->oasis.tx.method = registryUnfreezeNode;
-    }
-    if (CBOR_KEY_MATCHES(value, "registry.RegisterEntity")) {
-        v->oasis.tx.method = registryRegisterEntity;
+    if (!cbor_value_is_text_string(value) || !cbor_value_is_length_known(value)) {
+        return parser_unexpected_method;
     }
 
+    // Canonical strings are a single chunk, so the name can be compared in place
+    CborValue name = *value;
+    const char *namePtr;
+    size_t nameLen;
+    CHECK_CBOR_ERR(get_string_chunk(&name, (const void **) &namePtr, &nameLen))
+
+    v->oasis.tx.method = _lookupMethod(namePtr, nameLen);
     if (v->oasis.tx.method == unknownMethod)
         return parser_unexpected_method;
 
@@ -521,7 +571,7 @@ parser_error_t _readContext(parser_context_t *c, parser_tx_t *v) {
     return parser_ok;
 }
 
-__Z_INLINE parser_error_t _readTx(parser_tx_t *v, CborValue *it) {
+__Z_INLINE parser_error_t _readTx(const parser_context_t *c, parser_tx_t *v, CborValue *it) {
 
     MEMZERO(&v->oasis.tx, sizeof(oasis_tx_t));
 
@@ -529,32 +579,52 @@ __Z_INLINE parser_error_t _readTx(parser_tx_t *v, CborValue *it) {
 
     CHECK_CBOR_TYPE(cbor_value_get_type(it), CborMapType)
 
-    // Find method and read it first
-    CborValue methodField;
-    CHECK_CBOR_ERR(cbor_value_map_find_value(it, "method", &methodField))
-    CHECK_PARSER_ERR(_readMethod(v, &methodField))
-    valuesCount++;
+    // Walk the map once, in canonical key order: fee, body, nonce, method
+    // https://tools.ietf.org/html/rfc7049#section-3.9
+    CborValue contents;
+    CHECK_CBOR_ERR(cbor_value_enter_container(it, &contents))
 
-    CborValue feeField;
-    CHECK_CBOR_ERR(cbor_value_map_find_value(it, "fee", &feeField))
     v->oasis.tx.has_fee = false;
 
     // We have fee
-    if (cbor_value_is_valid(&feeField)) {
-        CHECK_PARSER_ERR(_readFee(v, &feeField))
+    bool found;
+    CHECK_PARSER_ERR(_seekOptionalKey(&contents, "fee", &found))
+    if (found) {
+        // _readFee leaves the container, so contents already points to the next key
+        CHECK_PARSER_ERR(_readFee(v, &contents))
         valuesCount++;
     }
 
-    CborValue nonceField;
-    CHECK_CBOR_ERR(cbor_value_map_find_value(it, "nonce", &nonceField))
-    CHECK_PARSER_ERR(_readNonce(v, &nonceField))
+    // Body depends on the method, which comes later. Keep it and read it at the end
+    CborValue bodyField;
+    bool hasBody;
+    CHECK_PARSER_ERR(_seekOptionalKey(&contents, "body", &hasBody))
+    if (hasBody) {
+        bodyField = contents;
+        CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    }
+
+    CHECK_PARSER_ERR(_seekOptionalKey(&contents, "nonce", &found))
+    if (!found) {
+        return parser_required_nonce;
+    }
+    CHECK_PARSER_ERR(_readNonce(v, &contents))
+    CHECK_CBOR_ERR(cbor_value_advance(&contents))
+    valuesCount++;
+
+    CHECK_PARSER_ERR(_seekOptionalKey(&contents, "method", &found))
+    if (!found) {
+        return parser_required_method;
+    }
+    CHECK_PARSER_ERR(_readMethod(v, &contents))
     valuesCount++;
 
     if (v->oasis.tx.method != registryDeregisterEntity) {
         // This method doesn't have a body
-        CborValue bodyField;
-        CHECK_CBOR_ERR(cbor_value_map_find_value(it, "body", &bodyField))
-        CHECK_PARSER_ERR(_readBody(v, &bodyField))
+        if (!hasBody) {
+            return parser_unexpected_type;
+        }
+        CHECK_PARSER_ERR(_readBody(c, v, &bodyField))
         valuesCount++;
     }
 
@@ -609,10 +679,16 @@ parser_error_t _extractContextSuffix(parser_tx_t *v) {
 
 parser_error_t _read(const parser_context_t *c, parser_tx_t *v) {
     CborValue it;
-    INIT_CBOR_PARSER(c, it)
+    CborParser parser;
 
-    // validate CBOR canonical order before even trying to parse
-    CHECK_CBOR_ERR(cbor_value_validate(&it, CborValidateCanonicalFormat))
+    // CBOR canonical format is validated while fields are read (see CHECK_CBOR_CANONICAL)
+    // unless it was already validated as the buffer was received
+    uint32_t flags = CborValidateCanonicalFormat;
+    if (c->cborValidated) {
+        flags |= CBOR_FLAG_VALIDATED;
+    }
+    CHECK_CBOR_ERR(cbor_parser_init(c->buffer + c->offset, c->bufferLen - c->offset,
+                                    flags, &parser, &it))
 
     if (cbor_value_at_end(&it)) {
         return parser_unexpected_buffer_end;
@@ -621,16 +697,20 @@ parser_error_t _read(const parser_context_t *c, parser_tx_t *v) {
     if (!cbor_value_is_map(&it)) {
         return parser_unexpected_type;
     }
+    CHECK_CBOR_CANONICAL(&it)
 
     // ENTITY OR TX ?
-    CborValue idField;
-    CHECK_CBOR_ERR(cbor_value_map_find_value(&it, "id", &idField))
+    // In canonical order, "id" is the first key of an entity
+    CborValue firstKey;
+    CHECK_CBOR_ERR(cbor_value_enter_container(&it, &firstKey))
 
     // default Unknown type
     v->type = unknownType;
-    if (cbor_value_get_type(&idField) == CborInvalidType) {
+    bool isEntity;
+    CHECK_PARSER_ERR(_seekOptionalKey(&firstKey, "id", &isEntity))
+    if (!isEntity) {
         // READ TX
-        CHECK_PARSER_ERR(_readTx(v, &it))
+        CHECK_PARSER_ERR(_readTx(c, v, &it))
         v->type = txType;
     } else {
         // READ ENTITY
@@ -654,184 +734,148 @@ parser_error_t _read(const parser_context_t *c, parser_tx_t *v) {
     return parser_ok;
 }
 
-parser_error_t _validateTx(const parser_context_t *c, const parser_tx_t *v) {
-    CborValue it;
-    INIT_CBOR_PARSER(c, it)
-
+__Z_INLINE parser_error_t _validateQuantity(const quantity_t *q) {
+    if (q->len > QUANTITY_MAX_LEN) {
+        return parser_value_out_of_range;
+    }
     return parser_ok;
 }
 
-uint8_t _getNumItems(const parser_context_t *c, const parser_tx_t *v) {
-    // typical tx: Type, Fee, Gas, + Body
-    uint8_t itemCount = 3;
-
-    // Entity (not a tx)
-    if (v->type == entityType) {
-        itemCount = 3 + v->oasis.entity.nodes_length;
-        return itemCount;
-    }
-
-    if (!v->oasis.tx.has_fee)
-        itemCount = 1;
-
-    switch (v->oasis.tx.method) {
-        case stakingTransfer:
-            itemCount += 2;
-            break;
-        case stakingBurn:
-            itemCount += 1;
-            break;
-        case stakingAddEscrow:
-            itemCount += 2;
-            break;
-        case stakingReclaimEscrow:
-            itemCount += 2;
-            break;
-        case stakingAmendCommissionSchedule:
-            // Each rate contains 2 items (start & rate)
-            itemCount += v->oasis.tx.body.stakingAmendCommissionSchedule.rates_length * 2;
-            // Each bound contains 3 items (start, rate_max & rate_min)
-            itemCount += v->oasis.tx.body.stakingAmendCommissionSchedule.bounds_length * 3;
-            break;
-        case registryDeregisterEntity:
-            itemCount += 0;
-            break;
-        case registryUnfreezeNode:
-            itemCount += 1;
-            break;
-        case registryRegisterEntity:
-            // 2 items for signature plus number of items for entity blob
-            itemCount += 2 + 2 + v->oasis.tx.body.registryRegisterEntity.entity.nodes_length;
-            break;
-        case unknownMethod:
-        default:
-            break;
-    }
-
-    return itemCount;
-}
+__Z_INLINE parser_error_t _getEntityNodesContainer(const oasis_entity_t *entity, CborValue *nodes) {
+    CborValue it = entity->cborState.startValue;
 
-__Z_INLINE parser_error_t _getAmendmentContainer(CborValue *value, CborValue *amendmentContainer) {
-    if (cbor_value_at_end(value)) {
+    if (cbor_value_at_end(&it)) {
         return parser_unexpected_buffer_end;
     }
 
-
-    if (!cbor_value_is_map(value)) {
-        return parser_unexpected_type;
-    }
-
-    CborValue bodyContainer;
-    CHECK_CBOR_ERR(cbor_value_map_find_value(value, "body", &bodyContainer))
-
-    if (!cbor_value_is_map(&bodyContainer)) {
+    if (!cbor_value_is_map(&it)) {
         return parser_unexpected_type;
     }
 
-    CHECK_CBOR_ERR(cbor_value_map_find_value(&bodyContainer, "amendment", amendmentContainer))
+    CborValue nodesContainer;
+    CHECK_CBOR_ERR(cbor_value_enter_container(&it, &nodesContainer))
+    CHECK_PARSER_ERR(_seekKey(&nodesContainer, "nodes"))
 
-    if (!cbor_value_is_map(amendmentContainer)) {
+    if (!cbor_value_is_array(&nodesContainer)) {
         return parser_unexpected_type;
     }
 
+    CHECK_CBOR_ERR(cbor_value_enter_container(&nodesContainer, nodes))
     return parser_ok;
 }
 
-__Z_INLINE parser_error_t _getRatesContainer(CborValue *value, CborValue *ratesContainer) {
+__Z_INLINE parser_error_t _validateEntity(const oasis_entity_t *entity) {
+    // Node ids are only read when displayed, so make sure all of them can be read
+    CborValue nodes;
+    CHECK_PARSER_ERR(_getEntityNodesContainer(entity, &nodes))
 
-    CborValue amendmentContainer;
-    CHECK_PARSER_ERR(_getAmendmentContainer(value, &amendmentContainer))
+    for (size_t i = 0; i < entity->nodes_length; i++) {
+        publickey_t node;
+        CHECK_PARSER_ERR(_readPublicKey(&nodes, &node))
+        CHECK_CBOR_ERR(cbor_value_advance(&nodes))
+    }
 
-    CborValue container;
-    CHECK_CBOR_ERR(cbor_value_map_find_value(&amendmentContainer, "rates", &container))
+    return parser_ok;
+}
 
-    if (!cbor_value_is_array(&container)) {
-        return parser_unexpected_type;
+__Z_INLINE parser_error_t _validateAmendment(const parser_context_t *c, const parser_tx_t *v) {
+    for (uint8_t i = 0; i < v->oasis.tx.body.stakingAmendCommissionSchedule.rates_length; i++) {
+        commissionRateStep_t rate;
+        CHECK_PARSER_ERR(_getCommissionRateStepAtIndex(c, v, &rate, i))
+        CHECK_PARSER_ERR(_validateQuantity(&rate.rate))
     }
 
-    CHECK_CBOR_ERR(cbor_value_enter_container(&container, ratesContainer))
+    for (uint8_t i = 0; i < v->oasis.tx.body.stakingAmendCommissionSchedule.bounds_length; i++) {
+        commissionRateBoundStep_t bound;
+        CHECK_PARSER_ERR(_getCommissionBoundStepAtIndex(c, v, &bound, i))
+        CHECK_PARSER_ERR(_validateQuantity(&bound.rate_min))
+        CHECK_PARSER_ERR(_validateQuantity(&bound.rate_max))
+    }
 
     return parser_ok;
 }
 
-__Z_INLINE parser_error_t _getBoundsContainer(CborValue *value, CborValue *boundsContainer) {
-
-    CborValue amendmentContainer;
-    CHECK_PARSER_ERR(_getAmendmentContainer(value, &amendmentContainer))
+parser_error_t _validateTx(const parser_context_t *c, const parser_tx_t *v) {
+    // Check that every item can be rendered, without formatting any of them
 
-    CborValue container;
-    CHECK_CBOR_ERR(cbor_value_map_find_value(&amendmentContainer, "bounds", &container))
+    if (v->type == entityType) {
+        return _validateEntity(&v->oasis.entity);
+    }
 
-    if (!cbor_value_is_array(&container)) {
+    if (v->type != txType) {
         return parser_unexpected_type;
     }
 
-    CHECK_CBOR_ERR(cbor_value_enter_container(&container, boundsContainer))
+    if (v->oasis.tx.has_fee) {
+        CHECK_PARSER_ERR(_validateQuantity(&v->oasis.tx.fee_amount))
+    }
 
-    return parser_ok;
+    switch (v->oasis.tx.method) {
+        case stakingTransfer:
+            return _validateQuantity(&v->oasis.tx.body.stakingTransfer.xfer_tokens);
+        case stakingBurn:
+            return _validateQuantity(&v->oasis.tx.body.stakingBurn.burn_tokens);
+        case stakingAddEscrow:
+            return _validateQuantity(&v->oasis.tx.body.stakingAddEscrow.escrow_tokens);
+        case stakingReclaimEscrow:
+            return _validateQuantity(&v->oasis.tx.body.stakingReclaimEscrow.reclaim_shares);
+        case stakingAmendCommissionSchedule:
+            return _validateAmendment(c, v);
+        case registryDeregisterEntity:
+        case registryUnfreezeNode:
+            return parser_ok;
+        case registryRegisterEntity:
+            return _validateEntity(&v->oasis.tx.body.registryRegisterEntity.entity);
+        case unknownMethod:
+        default:
+            return parser_unexpected_method;
+    }
 }
 
-parser_error_t _getCommissionRateStepAtIndex(const parser_context_t *c, commissionRateStep_t *rate, uint8_t index) {
-    CborValue it;
-    INIT_CBOR_PARSER(c, it)
-
-    // We should have already initiated v but should we verify ?
+parser_error_t _getCommissionRateStepAtIndex(const parser_context_t *c,
+                                             const parser_tx_t *v,
+                                             commissionRateStep_t *rate,
+                                             uint8_t index) {
+    if (index >= v->oasis.tx.body.stakingAmendCommissionSchedule.rates_length) {
+        return parser_no_data;
+    }
 
-    CborValue ratesContainer;
-    CHECK_PARSER_ERR(_getRatesContainer(&it, &ratesContainer))
+    // Seek straight to the element that was indexed while parsing
+    const uint16_t offset = v->oasis.tx.body.stakingAmendCommissionSchedule.steps_offset[index];
 
-    for (int i = 0; i < index; i++) {
-        CHECK_CBOR_ERR(cbor_value_advance(&ratesContainer))
-    }
+    CborValue it;
+    CborParser parser;
+    CHECK_CBOR_ERR(cbor_parser_init(c->buffer + offset, c->bufferLen - offset, 0, &parser, &it))
 
-    CHECK_PARSER_ERR(_readRate(&ratesContainer, rate))
+    CHECK_PARSER_ERR(_readRate(&it, rate))
 
     return parser_ok;
-
 }
 
 parser_error_t _getCommissionBoundStepAtIndex(const parser_context_t *c,
+                                              const parser_tx_t *v,
                                               commissionRateBoundStep_t *bound,
                                               uint8_t index) {
-    CborValue it;
-    INIT_CBOR_PARSER(c, it)
-
-    if (cbor_value_at_end(&it)) {
-        return parser_unexpected_buffer_end;
+    if (index >= v->oasis.tx.body.stakingAmendCommissionSchedule.bounds_length) {
+        return parser_no_data;
     }
 
-    CborValue boundsContainer;
-    CHECK_PARSER_ERR(_getBoundsContainer(&it, &boundsContainer))
+    // Seek straight to the element that was indexed while parsing
+    const uint16_t offset = v->oasis.tx.body.stakingAmendCommissionSchedule.steps_offset[
+            v->oasis.tx.body.stakingAmendCommissionSchedule.rates_length + index];
 
-    for (int i = 0; i < index; i++) {
-        CHECK_CBOR_ERR(cbor_value_advance(&boundsContainer))
-    }
+    CborValue it;
+    CborParser parser;
+    CHECK_CBOR_ERR(cbor_parser_init(c->buffer + offset, c->bufferLen - offset, 0, &parser, &it))
 
-    CHECK_PARSER_ERR(_readBound(&boundsContainer, bound))
+    CHECK_PARSER_ERR(_readBound(&it, bound))
 
     return parser_ok;
 }
 
 parser_error_t _getEntityNodesIdAtIndex(const oasis_entity_t *entity, publickey_t *node, uint8_t index) {
-    CborValue it = entity->cborState.startValue;
-
-    if (cbor_value_at_end(&it)) {
-        return parser_unexpected_buffer_end;
-    }
-
-    if (!cbor_value_is_map(&it)) {
-        return parser_unexpected_type;
-    }
-
-    CborValue nodesContainer;
-    CHECK_CBOR_ERR(cbor_value_map_find_value(&it, "nodes", &nodesContainer))
-
-    if (!cbor_value_is_array(&nodesContainer)) {
-        return parser_unexpected_type;
-    }
-
     CborValue nodesArrayContainer;
-    CHECK_CBOR_ERR(cbor_value_enter_container(&nodesContainer, &nodesArrayContainer))
+    CHECK_PARSER_ERR(_getEntityNodesContainer(entity, &nodesArrayContainer))
 
     for (int i = 0; i < index; i++) {
         CHECK_CBOR_ERR(cbor_value_advance(&nodesArrayContainer))
@@ -25,8 +25,6 @@ extern "C" {
 extern const char context_prefix_tx[];
 extern const char context_prefix_entity[];
 
-extern parser_tx_t parser_tx_obj;
-
 parser_error_t parser_init(parser_context_t *ctx, const uint8_t *buffer, uint16_t bufferSize);
 
 parser_error_t _read(const parser_context_t *c, parser_tx_t *v);
@@ -35,13 +33,13 @@ parser_error_t _readContext(parser_context_t *c, parser_tx_t *v);
 
 parser_error_t _validateTx(const parser_context_t *c, const parser_tx_t *v);
 
-uint8_t _getNumItems(const parser_context_t *c, const parser_tx_t *v);
-
 parser_error_t _getCommissionRateStepAtIndex(const parser_context_t *c,
+                                             const parser_tx_t *v,
                                              commissionRateStep_t *rate,
                                              uint8_t index);
 
 parser_error_t _getCommissionBoundStepAtIndex(const parser_context_t *c,
+                                              const parser_tx_t *v,
                                               commissionRateBoundStep_t *bound,
                                               uint8_t index);
 
@@ -0,0 +1,267 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <zxmacros.h>
+#include "parser_stream.h"
+
+// Anything this scanner does not certify falls back to the batch parser, which
+// validates it with tinycbor. So it only needs to accept a subset of what
+// cbor_value_validate(CborValidateCanonicalFormat) accepts: definite lengths,
+// shortest form heads, no tags, no floats and sorted map keys.
+
+#define CBOR_MAJOR_UINT     0u
+#define CBOR_MAJOR_NEGINT   1u
+#define CBOR_MAJOR_BYTES    2u
+#define CBOR_MAJOR_TEXT     3u
+#define CBOR_MAJOR_ARRAY    4u
+#define CBOR_MAJOR_MAP      5u
+#define CBOR_MAJOR_TAG      6u
+#define CBOR_MAJOR_SIMPLE   7u
+
+typedef enum {
+    head_ok,
+    head_incomplete,
+    head_not_canonical,
+} head_result_e;
+
+__Z_INLINE head_result_e stream_readHead(const uint8_t *buffer, uint16_t bufferLen, uint16_t offset,
+                                         uint8_t *major, uint64_t *value, uint8_t *headLen) {
+    const uint8_t initial = buffer[offset];
+    const uint8_t info = initial & 0x1Fu;
+    *major = initial >> 5u;
+
+    if (info < 24) {
+        *value = info;
+        *headLen = 1;
+        return head_ok;
+    }
+
+    // indefinite lengths, breaks and reserved values
+    if (info > 27) {
+        return head_not_canonical;
+    }
+
+    const uint8_t argLen = 1u << (info - 24u);
+    if ((uint16_t) (bufferLen - offset) < (uint16_t) (1u + argLen)) {
+        return head_incomplete;
+    }
+
+    *value = 0;
+    for (uint8_t i = 0; i < argLen; i++) {
+        *value = (*value << 8u) | buffer[offset + 1 + i];
+    }
+    *headLen = 1 + argLen;
+
+    // shortest form
+    const uint64_t minValue = argLen == 1 ? 24 : (uint64_t) 1u << (4u * argLen);
+    if (*value < minValue) {
+        return head_not_canonical;
+    }
+
+    return head_ok;
+}
+
+// Same order as tinycbor's validate_container: header value, then encoded bytes
+__Z_INLINE bool stream_keysSorted(const uint8_t *buffer,
+                                  uint16_t prevStart, uint16_t prevEnd,
+                                  uint16_t start, uint16_t end) {
+    uint8_t major;
+    uint64_t prevValue = 0, value = 0;
+    uint8_t headLen;
+    stream_readHead(buffer, end, prevStart, &major, &prevValue, &headLen);
+    stream_readHead(buffer, end, start, &major, &value, &headLen);
+
+    if (prevValue != value) {
+        return prevValue < value;
+    }
+
+    const uint16_t prevLen = prevEnd - prevStart;
+    const uint16_t len = end - start;
+    int r = MEMCMP(buffer + prevStart, buffer + start, prevLen <= len ? prevLen : len);
+    if (r == 0 && prevLen != len) {
+        r = prevLen < len ? -1 : 1;
+    }
+    return r <= 0;
+}
+
+__Z_INLINE void stream_itemDone(parser_stream_t *stream, const uint8_t *buffer) {
+    while (stream->depth > 0) {
+        parser_stream_container_t *top = &stream->stack[stream->depth - 1];
+
+        if (top->isMap && top->remaining % 2 == 0) {
+            // That was a key
+            if (top->prevKeyEnd != 0 &&
+                !stream_keysSorted(buffer, top->prevKeyStart, top->prevKeyEnd, top->keyStart, stream->offset)) {
+                stream->state = stream_fallback;
+                return;
+            }
+            top->prevKeyStart = top->keyStart;
+            top->prevKeyEnd = stream->offset;
+        }
+
+        top->remaining--;
+        if (top->remaining > 0) {
+            return;
+        }
+
+        // The container is complete, and it is an item of its parent
+        stream->depth--;
+    }
+
+    stream->cborEnd = stream->offset;
+    stream->state = stream_done;
+}
+
+__Z_INLINE void stream_scanItem(parser_stream_t *stream, const uint8_t *buffer, uint16_t bufferLen) {
+    uint8_t major;
+    uint64_t value;
+    uint8_t headLen;
+
+    switch (stream_readHead(buffer, bufferLen, stream->offset, &major, &value, &headLen)) {
+        case head_ok:
+            break;
+        case head_incomplete:
+            return;
+        case head_not_canonical:
+        default:
+            stream->state = stream_fallback;
+            return;
+    }
+
+    if (stream->depth > 0) {
+        parser_stream_container_t *top = &stream->stack[stream->depth - 1];
+        if (top->isMap && top->remaining % 2 == 0) {
+            top->keyStart = stream->offset;
+        }
+    }
+
+    stream->offset += headLen;
+
+    switch (major) {
+        case CBOR_MAJOR_UINT:
+        case CBOR_MAJOR_NEGINT:
+            stream_itemDone(stream, buffer);
+            return;
+        case CBOR_MAJOR_BYTES:
+        case CBOR_MAJOR_TEXT:
+            if (value > UINT16_MAX) {
+                // cannot fit in the transaction buffer
+                stream->state = stream_fallback;
+                return;
+            }
+            if (value == 0) {
+                stream_itemDone(stream, buffer);
+                return;
+            }
+            stream->skip = (uint16_t) value;
+            return;
+        case CBOR_MAJOR_ARRAY:
+        case CBOR_MAJOR_MAP: {
+            // keys and values of a map are counted, a larger container cannot fit in the buffer anyway
+            if (value > UINT16_MAX / 2) {
+                stream->state = stream_fallback;
+                return;
+            }
+            if (value == 0) {
+                stream_itemDone(stream, buffer);
+                return;
+            }
+            if (stream->depth >= PARSER_STREAM_MAX_DEPTH) {
+                stream->state = stream_fallback;
+                return;
+            }
+            parser_stream_container_t *container = &stream->stack[stream->depth++];
+            container->isMap = major == CBOR_MAJOR_MAP;
+            container->remaining = (uint16_t) (container->isMap ? 2 * value : value);
+            container->keyStart = 0;
+            container->prevKeyStart = 0;
+            container->prevKeyEnd = 0;
+            return;
+        }
+        case CBOR_MAJOR_SIMPLE:
+            // false, true, null and undefined
+            if (value >= 20 && value <= 23 && headLen == 1) {
+                stream_itemDone(stream, buffer);
+                return;
+            }
+            stream->state = stream_fallback;
+            return;
+        case CBOR_MAJOR_TAG:
+        default:
+            stream->state = stream_fallback;
+            return;
+    }
+}
+
+void parser_stream_init(parser_stream_t *stream) {
+    MEMZERO(stream, sizeof(parser_stream_t));
+    stream->state = stream_context_len;
+}
+
+void parser_stream_feed(parser_stream_t *stream, const uint8_t *buffer, uint16_t bufferLen) {
+    while (stream->offset < bufferLen) {
+        const uint16_t offsetBefore = stream->offset;
+
+        switch (stream->state) {
+            case stream_context_len:
+                // See _readContext
+                stream->cborStart = 1 + buffer[0];
+                stream->offset = 1;
+                stream->state = stream_context;
+                break;
+            case stream_context:
+                if (bufferLen < stream->cborStart) {
+                    stream->offset = bufferLen;
+                    return;
+                }
+                stream->offset = stream->cborStart;
+                stream->state = stream_cbor;
+                break;
+            case stream_cbor:
+                if (stream->skip > 0) {
+                    const uint16_t available = bufferLen - stream->offset;
+                    if (stream->skip > available) {
+                        stream->skip -= available;
+                        stream->offset = bufferLen;
+                        return;
+                    }
+                    stream->offset += stream->skip;
+                    stream->skip = 0;
+                    stream_itemDone(stream, buffer);
+                    break;
+                }
+                stream_scanItem(stream, buffer, bufferLen);
+                if (stream->state == stream_cbor && stream->offset == offsetBefore) {
+                    // incomplete head, wait for more data
+                    return;
+                }
+                break;
+            case stream_done:
+                // Trailing data after the transaction
+                stream->state = stream_fallback;
+                return;
+            case stream_fallback:
+            default:
+                return;
+        }
+    }
+}
+
+bool parser_stream_validated(const parser_stream_t *stream, uint16_t bufferLen) {
+    return stream->state == stream_done &&
+           stream->offset == bufferLen &&
+           stream->cborEnd == bufferLen;
+}
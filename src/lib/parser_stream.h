@@ -0,0 +1,71 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Deepest container nesting that can be validated while streaming
+// Oasis transactions need 5 (tx / body / amendment / rates / rate), deeper items fall back
+#define PARSER_STREAM_MAX_DEPTH 6
+
+typedef enum {
+    stream_context_len,
+    stream_context,
+    stream_cbor,
+    // The CBOR item is complete and canonical
+    stream_done,
+    // Canonical format could not be confirmed, the batch parser will validate it
+    stream_fallback,
+} parser_stream_state_e;
+
+typedef struct {
+    uint16_t remaining;         // items left in the container (keys and values for maps)
+    bool isMap;
+    uint16_t keyStart;          // offsets of the current and previous map keys
+    uint16_t prevKeyStart;
+    uint16_t prevKeyEnd;
+} parser_stream_container_t;
+
+// Scans the transaction buffer as it is received, so the canonical CBOR checks
+// are done while chunks are still arriving and the final parse only extracts fields.
+// Only offsets are kept: the buffer may move (RAM to flash) between chunks.
+typedef struct {
+    parser_stream_state_e state;
+    uint16_t offset;            // next byte to scan
+    uint16_t cborStart;
+    uint16_t cborEnd;
+    uint16_t skip;              // string bytes still to skip
+    uint8_t depth;
+    parser_stream_container_t stack[PARSER_STREAM_MAX_DEPTH];
+} parser_stream_t;
+
+void parser_stream_init(parser_stream_t *stream);
+
+//// scans the bytes that were appended since the last call
+//// buffer must hold all the data received so far
+void parser_stream_feed(parser_stream_t *stream, const uint8_t *buffer, uint16_t bufferLen);
+
+//// true if the whole buffer was scanned and its CBOR is canonical
+bool parser_stream_validated(const parser_stream_t *stream, uint16_t bufferLen);
+
+#ifdef __cplusplus
+}
+#endif
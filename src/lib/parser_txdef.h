@@ -42,19 +42,35 @@ typedef enum {
 
 typedef struct {
     const uint8_t *ptr;
-    uint8_t len;
     const uint8_t *suffixPtr;
+    uint8_t len;
     uint8_t suffixLen;
 } context_t;
 
-typedef uint8_t publickey_t[32];
+// Rates and bounds of a schedule, together. A step shows at most 3 items, so with the Type,
+// the fee and the context every schedule of this length fits in the int8_t display indexes
+#define MAX_AMENDMENT_STEPS ((INT8_MAX + 1 - 4) / 3)
+
+// Keys, signatures and amounts are not copied, they point into the transaction buffer
+// (like context_t). The buffer is not modified while the transaction is reviewed, and
+// its address is already translated (PIC) when parsing starts, in RAM or in flash
+#define PUBLICKEY_LEN       32
+#define RAW_SIGNATURE_LEN   64
+// Same digit bound applied when printing
+#define QUANTITY_MAX_LEN    64
 
 typedef struct {
-    uint8_t buffer[64];
-    size_t len;
+    const uint8_t *ptr;     // PUBLICKEY_LEN bytes
+} publickey_t;
+
+typedef struct {
+    const uint8_t *ptr;     // big endian
+    uint8_t len;
 } quantity_t;
 
-typedef uint8_t raw_signature_t[64];
+typedef struct {
+    const uint8_t *ptr;     // RAW_SIGNATURE_LEN bytes
+} raw_signature_t;
 
 typedef struct {
     publickey_t public_key;
@@ -91,8 +107,8 @@ typedef struct {
 
 typedef struct {
     uint64_t fee_gas;
+    uint64_t nonce;
     quantity_t fee_amount;
-    bool has_fee;
 
     // Union type will depend on method
     union {
@@ -116,8 +132,10 @@ typedef struct {
         } stakingReclaimEscrow;
 
         struct {
-            size_t rates_length;
-            size_t bounds_length;
+            uint8_t rates_length;
+            uint8_t bounds_length;
+            // Offset of each rate / bound element (relative to the start of the buffer)
+            uint16_t steps_offset[MAX_AMENDMENT_STEPS];     // rates, then bounds
         } stakingAmendCommissionSchedule;
 
         struct {
@@ -131,8 +149,8 @@ typedef struct {
 
     } body;
 
-    uint64_t nonce;
     oasis_methods_e method;
+    bool has_fee;
 } oasis_tx_t;
 
 typedef enum {
@@ -143,13 +161,13 @@ typedef enum {
 
 typedef struct {
     context_t context;
+    // Here it fills the padding before the union (uint64_t aligned on ARM)
+    oasis_blob_type_e type;
 
     union {
         oasis_tx_t tx;
         oasis_entity_t entity;
     } oasis;
-
-    oasis_blob_type_e type;
 } parser_tx_t;
 
 #ifdef __cplusplus
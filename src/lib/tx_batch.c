@@ -0,0 +1,195 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <zxmacros.h>
+#include "tx_batch.h"
+#include "parser.h"
+#include "format.h"
+
+void tx_batch_init(tx_batch_t *batch) {
+    MEMZERO(batch, sizeof(tx_batch_t));
+    batch->parsedIdx = -1;
+}
+
+__Z_INLINE parser_error_t tx_batch_load(tx_batch_t *batch, parser_context_t *ctx,
+                                        const uint8_t *buffer, uint8_t txIdx) {
+    if (batch->parsedIdx == txIdx) {
+        return parser_ok;
+    }
+
+    batch->parsedIdx = -1;
+    const tx_batch_entry_t *entry = &batch->entries[txIdx];
+    CHECK_PARSER_ERR(parser_parse(ctx, buffer + entry->offset, entry->len))
+    batch->parsedIdx = (int8_t) txIdx;
+    return parser_ok;
+}
+
+parser_error_t tx_batch_index(tx_batch_t *batch, parser_context_t *ctx,
+                              const uint8_t *buffer, uint16_t bufferLen) {
+    tx_batch_init(batch);
+
+    uint16_t offset = 0;
+    while (offset < bufferLen) {
+        if (batch->count >= TX_BATCH_MAX_TX) {
+            return parser_batch_too_many_tx;
+        }
+        if (bufferLen - offset < TX_BATCH_LEN_SIZE) {
+            return parser_unexpected_buffer_end;
+        }
+
+        const uint16_t len = (uint16_t) ((buffer[offset] << 8u) | buffer[offset + 1]);
+        offset += TX_BATCH_LEN_SIZE;
+        if (len == 0 || len > bufferLen - offset) {
+            return parser_unexpected_buffer_end;
+        }
+
+        tx_batch_entry_t *entry = &batch->entries[batch->count];
+        entry->offset = offset;
+        entry->len = len;
+        batch->count++;
+
+        CHECK_PARSER_ERR(tx_batch_load(batch, ctx, buffer, batch->count - 1))
+        CHECK_PARSER_ERR(parser_validate(ctx))
+        entry->numItems = parser_getNumItems(ctx);
+
+        offset += len;
+    }
+
+    if (batch->count == 0) {
+        return parser_batch_empty;
+    }
+
+    // Display indexes are int8_t, items beyond that cannot be reached
+    uint16_t numItems = 1 + batch->count;
+    for (uint8_t i = 0; i < batch->count; i++) {
+        numItems += batch->entries[i].numItems;
+    }
+    if (numItems > INT8_MAX + 1) {
+        return parser_display_idx_out_of_range;
+    }
+    batch->numItems = (uint8_t) numItems;
+
+    return parser_ok;
+}
+
+uint8_t tx_batch_getNumItems(const tx_batch_t *batch) {
+    return batch->numItems;
+}
+
+parser_error_t tx_batch_getItem(tx_batch_t *batch, parser_context_t *ctx,
+                                const uint8_t *buffer,
+                                int8_t displayIdx,
+                                char *outKey, uint16_t outKeyLen,
+                                char *outValue, uint16_t outValueLen,
+                                uint8_t pageIdx, uint8_t *pageCount) {
+    MEMZERO(outKey, outKeyLen);
+    MEMZERO(outValue, outValueLen);
+    *pageCount = 1;
+
+    if (displayIdx < 0 || displayIdx >= batch->numItems) {
+        return parser_no_data;
+    }
+
+    if (displayIdx == 0) {
+        fmt_copy(outKey, outKeyLen, "Batch");
+
+        fmt_buffer_t f;
+        fmt_init(&f, outValue, outValueLen);
+        fmt_uint(&f, batch->count);
+        fmt_literal(&f, " transactions");
+        return parser_ok;
+    }
+
+    // Summary: the type of each transaction
+    uint8_t idx = (uint8_t) displayIdx - 1;
+    if (idx < batch->count) {
+        CHECK_PARSER_ERR(tx_batch_load(batch, ctx, buffer, idx))
+        const parser_error_t err = parser_getItem(ctx, 0, outKey, outKeyLen, outValue, outValueLen,
+                                                  pageIdx, pageCount);
+
+        fmt_buffer_t f;
+        fmt_init(&f, outKey, outKeyLen);
+        fmt_literal(&f, "Tx ");
+        fmt_uint(&f, idx + 1);
+        fmt_literal(&f, "/");
+        fmt_uint(&f, batch->count);
+        return err;
+    }
+
+    // Drill-down: the items of each transaction, prefixed with its number
+    idx -= batch->count;
+    for (uint8_t txIdx = 0; txIdx < batch->count; txIdx++) {
+        const tx_batch_entry_t *entry = &batch->entries[txIdx];
+        if (idx >= entry->numItems) {
+            idx -= entry->numItems;
+            continue;
+        }
+
+        CHECK_PARSER_ERR(tx_batch_load(batch, ctx, buffer, txIdx))
+
+        fmt_buffer_t f;
+        fmt_init(&f, outKey, outKeyLen);
+        fmt_uint(&f, txIdx + 1);
+        fmt_literal(&f, "/");
+        fmt_uint(&f, batch->count);
+        fmt_literal(&f, " ");
+        if (f.truncated) {
+            return parser_unexpected_value;
+        }
+        return parser_getItem(ctx, (int8_t) idx,
+                              outKey + f.len, outKeyLen - f.len,
+                              outValue, outValueLen,
+                              pageIdx, pageCount);
+    }
+
+    return parser_no_data;
+}
+
+uint8_t tx_batch_getItemPageCount(tx_batch_t *batch, parser_context_t *ctx,
+                                  const uint8_t *buffer,
+                                  int8_t displayIdx, uint16_t outValueLen) {
+    if (displayIdx < 0 || displayIdx >= batch->numItems) {
+        return 0;
+    }
+
+    if (displayIdx == 0) {
+        return 1;
+    }
+
+    // Summary: the type of each transaction
+    uint8_t idx = (uint8_t) displayIdx - 1;
+    if (idx < batch->count) {
+        if (tx_batch_load(batch, ctx, buffer, idx) != parser_ok) {
+            return 0;
+        }
+        return parser_getItemPageCount(ctx, 0, outValueLen);
+    }
+
+    // Drill-down: the items of each transaction
+    idx -= batch->count;
+    for (uint8_t txIdx = 0; txIdx < batch->count; txIdx++) {
+        if (idx >= batch->entries[txIdx].numItems) {
+            idx -= batch->entries[txIdx].numItems;
+            continue;
+        }
+        if (tx_batch_load(batch, ctx, buffer, txIdx) != parser_ok) {
+            return 0;
+        }
+        return parser_getItemPageCount(ctx, (int8_t) idx, outValueLen);
+    }
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "parser_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Transactions that can be signed in a single approval
+#if defined(TARGET_NANOX)
+#define TX_BATCH_MAX_TX         16
+#else
+#define TX_BATCH_MAX_TX         8
+#endif
+
+// Each transaction is preceded by its length (big endian)
+#define TX_BATCH_LEN_SIZE       2
+
+typedef struct {
+    uint16_t offset;            // first byte of the transaction (context length)
+    uint16_t len;
+    uint8_t numItems;
+} tx_batch_entry_t;
+
+// Index of the transactions in the tx buffer: [len][tx 0][len][tx 1]...
+// Each transaction has the same layout as a single one: [context len][context][cbor]
+typedef struct {
+    tx_batch_entry_t entries[TX_BATCH_MAX_TX];
+    uint8_t count;
+    uint8_t numItems;           // summary and the items of every transaction
+    int8_t parsedIdx;           // transaction loaded in the parser context, -1 if none
+    uint8_t signedCount;        // signatures returned after the approval
+} tx_batch_t;
+
+void tx_batch_init(tx_batch_t *batch);
+
+//// splits the buffer, then parses and validates every transaction
+parser_error_t tx_batch_index(tx_batch_t *batch, parser_context_t *ctx,
+                              const uint8_t *buffer, uint16_t bufferLen);
+
+//// summary (count and type of each transaction), then the items of each transaction
+uint8_t tx_batch_getNumItems(const tx_batch_t *batch);
+
+parser_error_t tx_batch_getItem(tx_batch_t *batch, parser_context_t *ctx,
+                                const uint8_t *buffer,
+                                int8_t displayIdx,
+                                char *outKey, uint16_t outKeyLen,
+                                char *outValue, uint16_t outValueLen,
+                                uint8_t pageIdx, uint8_t *pageCount);
+
+//// pages of an item with values of outValueLen, without formatting it (0 if there is no such item)
+uint8_t tx_batch_getItemPageCount(tx_batch_t *batch, parser_context_t *ctx,
+                                  const uint8_t *buffer,
+                                  int8_t displayIdx, uint16_t outValueLen);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,55 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "tx_digest.h"
+
+void tx_digest_init(tx_digest_t *digest) {
+    cx_sha512_init(&digest->ctx);
+    digest->bufferLen = 0;
+    digest->valid = true;
+}
+
+void tx_digest_append(tx_digest_t *digest, uint32_t bufferOffset, const uint8_t *chunk, uint32_t chunkLen) {
+    if (!digest->valid || bufferOffset != digest->bufferLen) {
+        // chunks are missing, the buffer will be hashed when signing
+        digest->valid = false;
+        return;
+    }
+
+    digest->bufferLen += chunkLen;
+
+    // Skip first byte (context length)
+    if (bufferOffset == 0 && chunkLen > 0) {
+        chunk++;
+        chunkLen--;
+    }
+
+    if (chunkLen > 0) {
+        cx_hash(&digest->ctx.header, 0, chunk, chunkLen, NULL, 0);
+    }
+}
+
+void tx_digest_final(tx_digest_t *digest, const uint8_t *buffer, uint32_t bufferLen, uint8_t *out) {
+    if (!digest->valid || digest->bufferLen != bufferLen) {
+        tx_digest_init(digest);
+        tx_digest_append(digest, 0, buffer, bufferLen);
+    }
+
+    cx_hash(&digest->ctx.header, CX_LAST, NULL, 0, out, CX_SHA512_SIZE);
+
+    // the context cannot be fed after the last block
+    digest->valid = false;
+}
@@ -0,0 +1,46 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zxmacros.h>
+#include "cx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SHA-512 of the message to sign, hashed as the tx buffer is received
+// The first byte of the buffer (context length) is not part of the message
+typedef struct {
+    cx_sha512_t ctx;
+    uint32_t bufferLen;         // tx buffer bytes hashed so far
+    bool valid;
+} tx_digest_t;
+
+void tx_digest_init(tx_digest_t *digest);
+
+//// hashes a chunk that was appended at bufferOffset of the tx buffer
+void tx_digest_append(tx_digest_t *digest, uint32_t bufferOffset, const uint8_t *chunk, uint32_t chunkLen);
+
+//// writes the message digest (CX_SHA512_SIZE bytes) of the tx buffer
+//// buffer is hashed again only if the chunks did not cover it
+void tx_digest_final(tx_digest_t *digest, const uint8_t *buffer, uint32_t bufferLen, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
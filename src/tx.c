@@ -18,6 +18,8 @@
 #include "apdu_codes.h"
 #include "buffering.h"
 #include "lib/parser.h"
+#include "lib/tx_digest.h"
+#include "lib/tx_batch.h"
 #include <string.h>
 #include "zxmacros.h"
 
@@ -27,6 +29,10 @@
 #elif defined(TARGET_NANOS)
 #define RAM_BUFFER_SIZE 384
 #define FLASH_BUFFER_SIZE 8192
+#else
+// Host build (tests and benchmarks) uses the Nano S sizes
+#define RAM_BUFFER_SIZE 384
+#define FLASH_BUFFER_SIZE 8192
 #endif
 
 // Ram
@@ -38,16 +44,30 @@ typedef struct {
 } storage_t;
 
 #if defined(TARGET_NANOS)
-storage_t N_appdata_impl __attribute__ ((aligned(64)));
+storage_t N_appdata_impl __attribute__ ((aligned(BUFFERING_FLASH_PAGE_SIZE)));
 #define N_appdata (*(storage_t *)PIC(&N_appdata_impl))
 
 #elif defined(TARGET_NANOX)
-storage_t const N_appdata_impl __attribute__ ((aligned(64)));
+storage_t const N_appdata_impl __attribute__ ((aligned(BUFFERING_FLASH_PAGE_SIZE)));
 #define N_appdata (*(volatile storage_t *)PIC(&N_appdata_impl))
+
+#else
+storage_t N_appdata_impl __attribute__ ((aligned(BUFFERING_FLASH_PAGE_SIZE)));
+#define N_appdata N_appdata_impl
 #endif
 
 parser_context_t ctx_parsed_tx;
 
+// Scans the tx as chunks arrive, so only field extraction is left for tx_parse
+parser_stream_t tx_stream;
+
+// Hashes the message to sign as chunks arrive, so signing only finalizes it
+tx_digest_t tx_digest;
+
+// Transactions of the buffer when several are signed with one approval
+tx_batch_t tx_batch;
+bool tx_batch_mode;
+
 void tx_initialize() {
     buffering_init(
         ram_buffer,
@@ -59,10 +79,31 @@ void tx_initialize() {
 
 void tx_reset() {
     buffering_reset();
+    parser_stream_init(&tx_stream);
+    tx_digest_init(&tx_digest);
+    tx_batch_init(&tx_batch);
+    tx_batch_mode = false;
+}
+
+bool tx_reserve(uint32_t length) {
+    return buffering_reserve(length) != 0;
 }
 
 uint32_t tx_append(unsigned char *buffer, uint32_t length) {
-    return buffering_append(buffer, length);
+    const uint32_t offset = tx_get_buffer_length();
+    const uint32_t appended = buffering_append(buffer, length);
+    if (appended > 0) {
+        tx_digest_append(&tx_digest, offset, buffer, appended);
+        // the buffer may have moved from RAM to flash, so it is read again
+        // Only the bytes already written can be scanned, tx_flush scans the rest
+        parser_stream_feed(&tx_stream, buffering_get_buffer()->data, buffering_get_committed_length());
+    }
+    return appended;
+}
+
+void tx_flush() {
+    buffering_flush();
+    parser_stream_feed(&tx_stream, buffering_get_buffer()->data, tx_get_buffer_length());
 }
 
 uint32_t tx_get_buffer_length() {
@@ -73,11 +114,17 @@ uint8_t *tx_get_buffer() {
     return buffering_get_buffer()->data;
 }
 
+void tx_get_digest(uint8_t *digest) {
+    tx_digest_final(&tx_digest, tx_get_buffer(), tx_get_buffer_length(), digest);
+}
+
 const char *tx_parse() {
-    uint8_t err = parser_parse(
+    tx_batch_mode = false;
+    uint8_t err = parser_parseStream(
         &ctx_parsed_tx,
         tx_get_buffer(),
-        tx_get_buffer_length());
+        tx_get_buffer_length(),
+        &tx_stream);
 
     if (err != parser_ok) {
         return parser_getErrorDescription(err);
@@ -91,7 +138,45 @@ const char *tx_parse() {
     return NULL;
 }
 
+const char *tx_parse_batch() {
+    tx_batch_mode = true;
+    const parser_error_t err = tx_batch_index(&tx_batch,
+                                              &ctx_parsed_tx,
+                                              tx_get_buffer(),
+                                              tx_get_buffer_length());
+    if (err != parser_ok) {
+        tx_batch_init(&tx_batch);
+        return parser_getErrorDescription(err);
+    }
+
+    return NULL;
+}
+
+bool tx_is_batch() {
+    return tx_batch_mode;
+}
+
+uint8_t tx_batch_get_signed_count() {
+    return tx_batch.signedCount;
+}
+
+bool tx_batch_next_digest(uint8_t *digest) {
+    if (!tx_batch_mode || tx_batch.signedCount >= tx_batch.count) {
+        return false;
+    }
+
+    // Same message as a single transaction: everything but the context length
+    const tx_batch_entry_t *entry = &tx_batch.entries[tx_batch.signedCount];
+    tx_digest_init(&tx_digest);
+    tx_digest_final(&tx_digest, tx_get_buffer() + entry->offset, entry->len, digest);
+    tx_batch.signedCount++;
+    return true;
+}
+
 uint8_t tx_getNumItems() {
+    if (tx_batch_mode) {
+        return tx_batch_getNumItems(&tx_batch);
+    }
     return parser_getNumItems(&ctx_parsed_tx);
 }
 
@@ -105,11 +190,21 @@ tx_error_t tx_getItem(int8_t displayIdx,
         return tx_no_data;
     }
 
-    err = (tx_error_t) parser_getItem(&ctx_parsed_tx,
-                                      displayIdx,
-                                      outKey, outKeyLen,
-                                      outVal, outValLen,
-                                      pageIdx, pageCount);
+    if (tx_batch_mode) {
+        err = (tx_error_t) tx_batch_getItem(&tx_batch,
+                                            &ctx_parsed_tx,
+                                            tx_get_buffer(),
+                                            displayIdx,
+                                            outKey, outKeyLen,
+                                            outVal, outValLen,
+                                            pageIdx, pageCount);
+    } else {
+        err = (tx_error_t) parser_getItem(&ctx_parsed_tx,
+                                          displayIdx,
+                                          outKey, outKeyLen,
+                                          outVal, outValLen,
+                                          pageIdx, pageCount);
+    }
 
     // Convert error codes
     if (err == parser_no_data ||
@@ -122,3 +217,10 @@ tx_error_t tx_getItem(int8_t displayIdx,
 
     return err;
 }
+
+uint8_t tx_getItemPageCount(int8_t displayIdx, uint16_t outValueLen) {
+    if (tx_batch_mode) {
+        return tx_batch_getItemPageCount(&tx_batch, &ctx_parsed_tx, tx_get_buffer(), displayIdx, outValueLen);
+    }
+    return parser_getItemPageCount(&ctx_parsed_tx, displayIdx, outValueLen);
+}
@@ -15,9 +15,14 @@
 ********************************************************************************/
 #pragma once
 
+#include <stdbool.h>
 #include "os.h"
 #include "coin.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef enum {
     tx_no_error = 0,
     tx_no_data = 1,
@@ -28,6 +33,12 @@ void tx_initialize();
 /// Clears the transaction buffer
 void tx_reset();
 
+/// Declares the total length of the transaction buffer before the first append
+/// RAM or flash is chosen once for the whole transaction
+/// \param length
+/// \return false if it does not fit
+bool tx_reserve(uint32_t length);
+
 /// Appends buffer to the end of the current transaction buffer
 /// Transaction buffer will grow until it reaches the maximum allowed size
 /// \param buffer
@@ -35,19 +46,45 @@ void tx_reset();
 /// \return It returns an error message if the buffer is too small.
 uint32_t tx_append(unsigned char *buffer, uint32_t length);
 
+/// Writes the bytes that are still staged in RAM to flash
+/// Call it after the last chunk, flash is otherwise written in whole pages
+void tx_flush();
+
 /// Returns size of the raw json transaction buffer
 /// \return
 uint32_t tx_get_buffer_length();
 
 /// Returns the raw json transaction buffer
+/// Bytes still staged in RAM are not in it until tx_flush is called
 /// \return
 uint8_t *tx_get_buffer();
 
+/// Writes the SHA-512 digest of the message to sign (buffer without its first byte)
+/// The message is hashed as it is appended, so this only finalizes the hash
+/// \param digest CX_SHA512_SIZE bytes
+void tx_get_digest(uint8_t *digest);
+
 /// Parse message stored in transaction buffer
 /// This function should be called as soon as full buffer data is loaded.
 /// \return It returns NULL if json is valid or error message otherwise.
 const char *tx_parse();
 
+/// Parse the transactions of a batch stored in the transaction buffer
+/// Each one is preceded by its length (2 bytes, big endian)
+/// \return It returns NULL if all of them are valid or error message otherwise.
+const char *tx_parse_batch();
+
+/// True if the buffer holds a batch (tx_parse_batch was called after tx_reset)
+bool tx_is_batch();
+
+/// Number of batch signatures already returned
+uint8_t tx_batch_get_signed_count();
+
+/// Writes the digest of the next transaction of the batch to sign
+/// \param digest CX_SHA512_SIZE bytes
+/// \return false if all of them were signed
+bool tx_batch_next_digest(uint8_t *digest);
+
 /// Return the number of items in the transaction
 uint8_t tx_getNumItems();
 
@@ -56,3 +93,11 @@ tx_error_t tx_getItem(int8_t displayIdx,
                            char *outKey, uint16_t outKeyLen,
                            char *outValue, uint16_t outValueLen,
                            uint8_t pageIdx, uint8_t *pageCount);
+
+/// Number of pages of an item when values are outValueLen bytes long, without formatting it
+/// \return 0 if there is no such item
+uint8_t tx_getItemPageCount(int8_t displayIdx, uint16_t outValueLen);
+
+#ifdef __cplusplus
+}
+#endif
@@ -28,7 +28,6 @@
 #include "tx.h"
 
 #include <string.h>
-#include <stdio.h>
 
 view_t viewdata;
 
@@ -84,28 +83,22 @@ void h_review_increase() {
 void h_review_decrease() {
     viewdata.pageIdx--;
     if (viewdata.pageIdx < 0) {
+        // Last page of the previous item, counted without formatting it
         viewdata.idx--;
-        viewdata.pageIdx = 0;
+        const uint8_t pageCount = tx_getItemPageCount(viewdata.idx, MAX_CHARS_PER_VALUE1_LINE);
+        viewdata.pageIdx = pageCount > 0 ? (int8_t) (pageCount - 1) : 0;
     }
 }
 
 view_error_t h_review_update_data() {
-    tx_error_t err = tx_no_error;
-
-    do {
-        err = tx_getItem(viewdata.idx,
-                         viewdata.key, MAX_CHARS_PER_KEY_LINE,
-                         viewdata.value, MAX_CHARS_PER_VALUE1_LINE,
-                         viewdata.pageIdx, &viewdata.pageCount);
-
-        if (err == tx_no_data) {
-            return view_no_data;
-        }
+    const tx_error_t err = tx_getItem(viewdata.idx,
+                                      viewdata.key, MAX_CHARS_PER_KEY_LINE,
+                                      viewdata.value, MAX_CHARS_PER_VALUE1_LINE,
+                                      viewdata.pageIdx, &viewdata.pageCount);
 
-        if (viewdata.pageCount == 0) {
-            h_review_increase();
-        }
-    } while (viewdata.pageCount == 0);
+    if (err == tx_no_data) {
+        return view_no_data;
+    }
 
     if (err != tx_no_error) {
         return view_error_detected;
@@ -119,11 +112,14 @@ view_error_t h_addr_update_item(uint8_t idx) {
     MEMZERO(viewdata.addr, MAX_CHARS_ADDR);
     switch (idx) {
         case 0:
-            snprintf(viewdata.addr, MAX_CHARS_ADDR, "%s", (char *) (G_io_apdu_buffer + PK_LEN));
+            fmt_copy(viewdata.addr, MAX_CHARS_ADDR, (char *) (G_io_apdu_buffer + PK_LEN));
             break;
-        case 1:
-            bip44_to_str(viewdata.addr, MAX_CHARS_ADDR, bip44Path);
+        case 1: {
+            fmt_buffer_t f;
+            fmt_init(&f, viewdata.addr, MAX_CHARS_ADDR);
+            fmt_bip44(&f, bip44Path, BIP44_LEN_DEFAULT);
             break;
+        }
     }
     return view_no_error;
 }
@@ -145,8 +141,8 @@ void view_address_show() {
 }
 
 void view_error_show() {
-    snprintf(viewdata.key, MAX_CHARS_PER_KEY_LINE, "ERROR");
-    snprintf(viewdata.value, MAX_CHARS_PER_VALUE1_LINE, "SHOWING DATA");
+    fmt_copy(viewdata.key, MAX_CHARS_PER_KEY_LINE, "ERROR");
+    fmt_copy(viewdata.value, MAX_CHARS_PER_VALUE1_LINE, "SHOWING DATA");
     splitValueField();
     view_error_show_impl();
 }
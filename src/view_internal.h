@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "lib/format.h"
 
 #define MENU_MAIN_APP_LINE1 "Oasis"
 
@@ -69,12 +70,12 @@ typedef enum {
     view_error_detected = 2
 } view_error_t;
 
-#define print_title(...) snprintf(viewdata.title, sizeof(viewdata.title), __VA_ARGS__)
-#define print_key(...) snprintf(viewdata.key, sizeof(viewdata.key), __VA_ARGS__);
-#define print_value(...) snprintf(viewdata.value, sizeof(viewdata.value), __VA_ARGS__);
+#define print_title(s) fmt_copy(viewdata.title, sizeof(viewdata.title), s)
+#define print_key(s) fmt_copy(viewdata.key, sizeof(viewdata.key), s);
+#define print_value(s) fmt_copy(viewdata.value, sizeof(viewdata.value), s);
 
 #if defined(TARGET_NANOS)
-#define print_value2(...) snprintf(viewdata.value2, sizeof(viewdata.value2), __VA_ARGS__);
+#define print_value2(s) fmt_copy(viewdata.value2, sizeof(viewdata.value2), s);
 #endif
 
 void splitValueField();
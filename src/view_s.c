@@ -24,9 +24,9 @@
 #include "zxmacros.h"
 #include "view_templates.h"
 #include "tx.h"
+#include "lib/crypto.h"
 
 #include <string.h>
-#include <stdio.h>
 
 #if defined(TARGET_NANOS)
 
@@ -38,6 +38,7 @@ void view_sign_show_s();
 ux_state_t ux;
 
 void os_exit(uint32_t id) {
+    crypto_clearAddressCache();
     os_sched_exit(0);
 }
 
@@ -24,9 +24,9 @@
 #include "zxmacros.h"
 #include "view_templates.h"
 #include "tx.h"
+#include "lib/crypto.h"
 
 #include <string.h>
-#include <stdio.h>
 
 #if defined(TARGET_NANOX)
 
@@ -39,9 +39,14 @@ ux_state_t G_ux;
 bolos_ux_params_t G_ux_params;
 uint8_t flow_inside_loop;
 
+void h_exit() {
+    crypto_clearAddressCache();
+    os_sched_exit(-1);
+}
+
 UX_FLOW_DEF_NOCB(ux_idle_flow_1_step, pbb, { &C_icon_app, MENU_MAIN_APP_LINE1, MENU_MAIN_APP_LINE2,});
 UX_FLOW_DEF_NOCB(ux_idle_flow_3_step, bn, { "Version", APPVERSION, });
-UX_FLOW_DEF_VALID(ux_idle_flow_4_step, pb, os_sched_exit(-1), { &C_icon_dashboard, "Quit",});
+UX_FLOW_DEF_VALID(ux_idle_flow_4_step, pb, h_exit(), { &C_icon_dashboard, "Quit",});
 const ux_flow_step_t *const ux_idle_flow [] = {
   &ux_idle_flow_1_step,
   &ux_idle_flow_3_step,
@@ -0,0 +1,135 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gtest/gtest.h>
+#include <cstring>
+#include "addr_cache.h"
+#include "crypto.h"
+
+namespace {
+    void makeEntry(uint32_t account, uint32_t path[ADDR_CACHE_PATH_LEN], uint8_t pk[ADDR_CACHE_PK_LEN], char *address) {
+        const uint32_t p[ADDR_CACHE_PATH_LEN] = {0x8000002c, 0x800001da, 0x80000000 | account, 0, 0};
+        memcpy(path, p, sizeof(p));
+        memset(pk, (int) account, ADDR_CACHE_PK_LEN);
+        snprintf(address, 16, "addr%u", account);
+    }
+
+    TEST(AddrCache, missThenHit) {
+        addr_cache_t cache;
+        addr_cache_init(&cache);
+
+        uint32_t path[ADDR_CACHE_PATH_LEN];
+        uint8_t pk[ADDR_CACHE_PK_LEN];
+        char address[16];
+        makeEntry(1, path, pk, address);
+
+        EXPECT_EQ(addr_cache_lookup(&cache, path), nullptr);
+        addr_cache_insert(&cache, path, pk, address);
+
+        const addr_cache_entry_t *entry = addr_cache_lookup(&cache, path);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(memcmp(entry->publicKey, pk, sizeof(pk)), 0);
+        EXPECT_STREQ(entry->address, address);
+
+        EXPECT_EQ(cache.hits, 1u);
+        EXPECT_EQ(cache.misses, 1u);
+
+        // Only the last element differs
+        path[4] = 1;
+        EXPECT_EQ(addr_cache_lookup(&cache, path), nullptr);
+        EXPECT_EQ(cache.misses, 2u);
+    }
+
+    TEST(AddrCache, evictsLeastRecentlyUsed) {
+        addr_cache_t cache;
+        addr_cache_init(&cache);
+
+        uint32_t path[ADDR_CACHE_PATH_LEN];
+        uint8_t pk[ADDR_CACHE_PK_LEN];
+        char address[16];
+
+        for (uint32_t account = 0; account < ADDR_CACHE_ENTRIES; account++) {
+            makeEntry(account, path, pk, address);
+            addr_cache_insert(&cache, path, pk, address);
+        }
+
+        // account 0 is used again, so account 1 is the oldest
+        makeEntry(0, path, pk, address);
+        ASSERT_NE(addr_cache_lookup(&cache, path), nullptr);
+
+        makeEntry(ADDR_CACHE_ENTRIES, path, pk, address);
+        addr_cache_insert(&cache, path, pk, address);
+
+        makeEntry(1, path, pk, address);
+        EXPECT_EQ(addr_cache_lookup(&cache, path), nullptr);
+        for (uint32_t account : {0u, 2u, 3u, (uint32_t) ADDR_CACHE_ENTRIES}) {
+            makeEntry(account, path, pk, address);
+            const addr_cache_entry_t *entry = addr_cache_lookup(&cache, path);
+            ASSERT_NE(entry, nullptr) << account;
+            EXPECT_STREQ(entry->address, address);
+        }
+    }
+
+    TEST(AddrCache, initClears) {
+        addr_cache_t cache;
+        addr_cache_init(&cache);
+
+        uint32_t path[ADDR_CACHE_PATH_LEN];
+        uint8_t pk[ADDR_CACHE_PK_LEN];
+        char address[16];
+        makeEntry(7, path, pk, address);
+        addr_cache_insert(&cache, path, pk, address);
+        addr_cache_lookup(&cache, path);
+
+        addr_cache_init(&cache);
+        EXPECT_EQ(cache.hits, 0u);
+        EXPECT_EQ(cache.misses, 0u);
+        EXPECT_EQ(addr_cache_lookup(&cache, path), nullptr);
+    }
+
+    TEST(AddrCache, fillAddress) {
+        crypto_clearAddressCache();
+        const uint32_t path[BIP44_LEN_DEFAULT] = {0x8000002c, 0x800001da, 0x80000000, 0, 5};
+        memcpy(bip44Path, path, sizeof(path));
+
+        uint8_t first[200];
+        uint8_t second[200];
+        memset(first, 0, sizeof(first));
+        memset(second, 0, sizeof(second));
+
+        const uint16_t firstLen = crypto_fillAddress(first, sizeof(first));
+        const uint16_t secondLen = crypto_fillAddress(second, sizeof(second));
+        ASSERT_GT(firstLen, PK_LEN);
+        EXPECT_EQ(firstLen, secondLen);
+        EXPECT_EQ(memcmp(first, second, sizeof(first)), 0);
+
+        uint16_t hits, misses;
+        crypto_addressCacheStats(&hits, &misses);
+        EXPECT_EQ(hits, 1u);
+        EXPECT_EQ(misses, 1u);
+
+        // Derived again after the cache is cleared
+        crypto_clearAddressCache();
+        crypto_addressCacheStats(&hits, &misses);
+        EXPECT_EQ(hits, 0u);
+        EXPECT_EQ(misses, 0u);
+        memset(second, 0, sizeof(second));
+        EXPECT_EQ(crypto_fillAddress(second, sizeof(second)), firstLen);
+        EXPECT_EQ(memcmp(first, second, sizeof(first)), 0);
+        crypto_addressCacheStats(&hits, &misses);
+        EXPECT_EQ(hits, 0u);
+        EXPECT_EQ(misses, 1u);
+    }
+}
@@ -0,0 +1,61 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gtest/gtest.h>
+#include <bech32.h>
+#include <cstring>
+#include "coin.h"
+#include "crypto.h"
+
+namespace {
+    TEST(Address, hrpState) {
+        EXPECT_EQ(bech32HrpState(COIN_HRP), COIN_HRP_STATE);
+    }
+
+    TEST(Address, publicKey) {
+        // Entity id from the register_entity test vectors
+        const uint8_t pk[32] = {
+                0xe6, 0xae, 0x44, 0xb0, 0xa6, 0x04, 0x4b, 0x8c, 0x2a, 0x4e, 0x07, 0x8b, 0x6b, 0x3b, 0x73, 0x4b,
+                0xd2, 0x3c, 0xa8, 0x2c, 0x04, 0x0d, 0x84, 0xb2, 0x7a, 0x7a, 0x3b, 0x66, 0x3b, 0xb1, 0x23, 0x4c,
+        };
+        char reference[100];
+        char address[100];
+
+        bech32EncodeFromBytes(reference, COIN_HRP, pk, sizeof(pk));
+        bech32EncodeFromBytes32(address, COIN_HRP, COIN_HRP_STATE, pk);
+        EXPECT_STREQ(address, reference);
+    }
+
+    TEST(Address, publicKeysFit) {
+        uint8_t buffer[258];
+        const uint32_t path[BIP44_LEN_DEFAULT] = {0x8000002c, 0x800001da, 0x80000000, 0, 0};
+        memcpy(bip44Path, path, sizeof(path));
+
+        // 8 keys fit in 258 bytes
+        EXPECT_EQ(crypto_fillPublicKeys(buffer, sizeof(buffer), 2, 0x80000000, 50), 1 + 8 * PK_LEN);
+        EXPECT_EQ(buffer[0], 8);
+
+        EXPECT_EQ(crypto_fillPublicKeys(buffer, sizeof(buffer), 4, 0, 3), 1 + 3 * PK_LEN);
+        EXPECT_EQ(buffer[0], 3);
+
+        EXPECT_EQ(crypto_fillPublicKeys(buffer, PK_LEN, 4, 0, 3), 1);
+        EXPECT_EQ(buffer[0], 0);
+
+        EXPECT_EQ(crypto_fillPublicKeys(buffer, sizeof(buffer), BIP44_LEN_DEFAULT, 0, 3), 0);
+
+        // The base path is not changed
+        EXPECT_EQ(memcmp(bip44Path, path, sizeof(path)), 0);
+    }
+}
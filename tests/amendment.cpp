@@ -0,0 +1,84 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gtest/gtest.h>
+#include "parser.h"
+#include "parser_impl.h"
+#include "../benchmarks/amendment.h"
+
+namespace {
+    // The context points into the buffer, so both are kept together
+    struct Parsed {
+        std::vector<uint8_t> buffer;
+        parser_context_t ctx;
+    };
+
+    parser_error_t parse(uint32_t rates, uint32_t bounds, Parsed *parsed) {
+        parsed->buffer = amendment::transaction(rates, bounds);
+        const parser_error_t err = parser_parse(&parsed->ctx, parsed->buffer.data(), parsed->buffer.size());
+        if (err != parser_ok) {
+            return err;
+        }
+        return parser_validate(&parsed->ctx);
+    }
+
+    TEST(Amendment, longestReviewable) {
+        // Type, fee amount and gas, 2 items per rate, 3 per bound and the context
+        Parsed parsed;
+        ASSERT_EQ(parse(0, MAX_AMENDMENT_STEPS, &parsed), parser_ok);
+        EXPECT_EQ(parser_getNumItems(&parsed.ctx), 3 + MAX_AMENDMENT_STEPS * 3 + 1);
+        EXPECT_LE(parser_getNumItems(&parsed.ctx), INT8_MAX + 1);
+
+        ASSERT_EQ(parse(MAX_AMENDMENT_STEPS, 0, &parsed), parser_ok);
+        EXPECT_EQ(parser_getNumItems(&parsed.ctx), 3 + MAX_AMENDMENT_STEPS * 2 + 1);
+    }
+
+    TEST(Amendment, stepsLimit) {
+        // rates and bounds share the limit
+        Parsed parsed;
+        EXPECT_EQ(parse(MAX_AMENDMENT_STEPS + 1, 0, &parsed), parser_unexpected_number_items);
+        EXPECT_EQ(parse(0, MAX_AMENDMENT_STEPS + 1, &parsed), parser_unexpected_number_items);
+        EXPECT_EQ(parse(20, MAX_AMENDMENT_STEPS - 20 + 1, &parsed), parser_unexpected_number_items);
+        EXPECT_EQ(parse(20, MAX_AMENDMENT_STEPS - 20, &parsed), parser_ok);
+    }
+
+    TEST(Amendment, everyStep) {
+        const auto buffer = amendment::transaction(25, 16);
+        parser_state_t state;
+        ASSERT_EQ(parser_state_parse(&state, buffer.data(), buffer.size()), parser_ok);
+        ASSERT_EQ(parser_state_validate(&state), parser_ok);
+        const parser_context_t *ctx = &state.ctx;
+        const parser_tx_t *tx = &state.tx;
+
+        for (uint8_t i = 0; i < 25; i++) {
+            commissionRateStep_t rate;
+            ASSERT_EQ(_getCommissionRateStepAtIndex(ctx, tx, &rate, i), parser_ok);
+            EXPECT_EQ(rate.start, 10u * i);
+            ASSERT_EQ(rate.rate.len, 2u);
+            EXPECT_EQ(rate.rate.ptr[0], 1 + i);
+        }
+        for (uint8_t i = 0; i < 16; i++) {
+            commissionRateBoundStep_t bound;
+            ASSERT_EQ(_getCommissionBoundStepAtIndex(ctx, tx, &bound, i), parser_ok);
+            EXPECT_EQ(bound.start, 10u * i);
+            ASSERT_EQ(bound.rate_min.len, 1u);
+            EXPECT_EQ(bound.rate_min.ptr[0], 1 + i);
+        }
+        commissionRateStep_t rate;
+        EXPECT_EQ(_getCommissionRateStepAtIndex(ctx, tx, &rate, 25), parser_no_data);
+        commissionRateBoundStep_t bound;
+        EXPECT_EQ(_getCommissionBoundStepAtIndex(ctx, tx, &bound, 16), parser_no_data);
+    }
+}
@@ -0,0 +1,122 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gtest/gtest.h>
+#include <cinttypes>
+#include <cstring>
+#include <string>
+#include <bech32.h>
+#include <zxmacros.h>
+#include "format.h"
+#include "coin.h"
+
+namespace {
+    // Each width from 0 to the length of the full text and one more
+    template<typename F>
+    void expectSameAsSnprintf(const std::string &expected, F append) {
+        for (uint16_t width = 0; width <= expected.size() + 1; width++) {
+            char out[128];
+            char ref[128];
+            memset(out, 'x', sizeof(out));
+            memset(ref, 'x', sizeof(ref));
+            snprintf(ref, width, "%s", expected.c_str());
+
+            fmt_buffer_t f;
+            fmt_init(&f, out, width);
+            append(&f);
+            EXPECT_EQ(memcmp(out, ref, sizeof(out)), 0) << expected << " width " << width;
+            EXPECT_EQ(f.truncated, width > 0 ? width <= expected.size() : !expected.empty()) << width;
+        }
+    }
+
+    TEST(Format, literals) {
+        expectSameAsSnprintf("Rates : [12] start", [](fmt_buffer_t *f) {
+            fmt_literal(f, "Rates : [");
+            fmt_uint(f, 12);
+            fmt_literal(f, "] start");
+        });
+        expectSameAsSnprintf("", [](fmt_buffer_t *f) { fmt_literal(f, ""); });
+        expectSameAsSnprintf("abc", [](fmt_buffer_t *f) { fmt_chars(f, "abcdef", 3); });
+
+        char out[4];
+        fmt_copy(out, sizeof(out), "True");
+        EXPECT_STREQ(out, "Tru");
+    }
+
+    TEST(Format, numbers) {
+        const uint64_t values[] = {0, 7, 10, 99, 128, UINT32_MAX, (uint64_t) UINT32_MAX + 1, 10000000000000000000u,
+                                   UINT64_MAX};
+        for (const uint64_t value : values) {
+            char ref[32];
+            snprintf(ref, sizeof(ref), "%" PRIu64, value);
+            expectSameAsSnprintf(ref, [=](fmt_buffer_t *f) { fmt_uint64(f, value); });
+            if (value <= UINT32_MAX) {
+                expectSameAsSnprintf(ref, [=](fmt_buffer_t *f) { fmt_uint(f, (uint32_t) value); });
+            }
+        }
+    }
+
+    TEST(Format, hex) {
+        const uint8_t data[] = {0x00, 0x1F, 0xA0, 0xFF};
+        char out[16];
+        fmt_buffer_t f;
+        fmt_init(&f, out, sizeof(out));
+        fmt_hex(&f, data, sizeof(data));
+        EXPECT_STREQ(out, "001FA0FF");
+        EXPECT_FALSE(f.truncated);
+
+        // only whole bytes
+        fmt_init(&f, out, 6);
+        fmt_hex(&f, data, sizeof(data));
+        EXPECT_STREQ(out, "001F");
+        EXPECT_TRUE(f.truncated);
+    }
+
+    TEST(Format, bech32) {
+        uint8_t key[32];
+        for (uint8_t i = 0; i < sizeof(key); i++) {
+            key[i] = (uint8_t) (i * 7u);
+        }
+        char expected[BECH32_BYTES32_ADDR_LEN(sizeof(COIN_HRP) - 1) + 1];
+        bech32EncodeFromBytes32(expected, COIN_HRP, COIN_HRP_STATE, key);
+
+        char out[128];
+        fmt_buffer_t f;
+        fmt_init(&f, out, sizeof(out));
+        fmt_literal(&f, "ID ");
+        fmt_bech32(&f, COIN_HRP, COIN_HRP_STATE, key);
+        EXPECT_EQ(std::string(out), std::string("ID ") + expected);
+        EXPECT_EQ(f.len, strlen(out));
+
+        // nothing when it does not fit whole
+        fmt_init(&f, out, sizeof(expected) - 1);
+        fmt_bech32(&f, COIN_HRP, COIN_HRP_STATE, key);
+        EXPECT_STREQ(out, "");
+        EXPECT_TRUE(f.truncated);
+    }
+
+    TEST(Format, bip44) {
+        const uint32_t paths[][5] = {
+                {0x8000002c, 0x800001da, 0x80000000, 0x80000000, 0x80000000},
+                {0x8000002c, 0x800001da, 0x80000005, 0, 17},
+                {0xFFFFFFFF, 0x7FFFFFFF, 0, 0x80000000, 1},
+        };
+        for (const auto &path : paths) {
+            char ref[64];
+            bip44_to_str(ref, sizeof(ref), path);
+            expectSameAsSnprintf(ref, [&](fmt_buffer_t *f) { fmt_bip44(f, path, 5); });
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Host stand-in for the subset of the BOLOS cx hash API used by the app
+// Only SHA-512 is provided
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CX_LAST         (1 << 0)
+#define CX_SHA512_SIZE  64
+
+typedef enum {
+    CX_NONE = 0,
+    CX_SHA512 = 5,
+} cx_md_t;
+
+typedef struct {
+    cx_md_t algo;
+    unsigned int counter;
+} cx_hash_t;
+
+typedef struct {
+    cx_hash_t header;
+    unsigned int blen;
+    unsigned char block[128];
+    uint64_t acc[8];
+} cx_sha512_t;
+
+int cx_sha512_init(cx_sha512_t *hash);
+
+int cx_hash(cx_hash_t *hash, int mode,
+            const unsigned char *in, unsigned int len,
+            unsigned char *out, unsigned int out_len);
+
+#ifdef __cplusplus
+}
+#endif
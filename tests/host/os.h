@@ -0,0 +1,7 @@
+#pragma once
+
+// Host stand-in for the BOLOS os.h, for the app sources that include it
+// (tx.c). Nothing from the SDK is used by them in host builds.
+
+#include <stdint.h>
+#include <stddef.h>
@@ -0,0 +1,183 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "parser.h"
+#include "../benchmarks/corpus.h"
+
+namespace {
+    std::vector<uint8_t> decode(const corpus_entry_t &entry) {
+        std::vector<uint8_t> buffer(strlen(entry.hex) / 2);
+        parseHexString(entry.hex, buffer.data());
+        return buffer;
+    }
+
+    // Every page of every item, one "key: value" line each
+    std::string renderState(parser_state_t *state) {
+        std::string out;
+        char key[40];
+        char value[40];
+        for (uint8_t idx = 0; idx < parser_state_getNumItems(state); idx++) {
+            uint8_t pageCount = 1;
+            for (uint8_t page = 0; page < pageCount; page++) {
+                const parser_error_t err = parser_state_getItem(state, idx, key, sizeof(key),
+                                                                value, sizeof(value), page, &pageCount);
+                out += std::string(key) + ": " + value + (err == parser_ok ? "" : " ERROR") + "\n";
+            }
+        }
+        return out;
+    }
+
+    std::string renderGlobal(const parser_context_t *ctx) {
+        std::string out;
+        char key[40];
+        char value[40];
+        for (uint8_t idx = 0; idx < parser_getNumItems(ctx); idx++) {
+            uint8_t pageCount = 1;
+            for (uint8_t page = 0; page < pageCount; page++) {
+                const parser_error_t err = parser_getItem(ctx, idx, key, sizeof(key),
+                                                          value, sizeof(value), page, &pageCount);
+                out += std::string(key) + ": " + value + (err == parser_ok ? "" : " ERROR") + "\n";
+            }
+        }
+        return out;
+    }
+
+    TEST(ParserState, sameItemsAsGlobal) {
+        for (const auto &entry : corpus) {
+            const auto buffer = decode(entry);
+
+            parser_context_t ctx;
+            const parser_error_t globalErr = parser_parse(&ctx, buffer.data(), buffer.size());
+
+            parser_state_t state;
+            ASSERT_EQ(parser_state_parse(&state, buffer.data(), buffer.size()), globalErr) << entry.name;
+            if (globalErr != parser_ok) {
+                continue;
+            }
+            EXPECT_EQ(parser_state_validate(&state), parser_validate(&ctx)) << entry.name;
+            EXPECT_EQ(renderState(&state), renderGlobal(&ctx)) << entry.name;
+        }
+    }
+
+    TEST(ParserState, interleavedStates) {
+        const auto transfer = decode(corpus[0]);
+        const auto entity = decode(corpus[sizeof(corpus) / sizeof(corpus[0]) - 1]);
+
+        parser_state_t a;
+        parser_state_t b;
+        ASSERT_EQ(parser_state_parse(&a, transfer.data(), transfer.size()), parser_ok);
+        const std::string expectedA = renderState(&a);
+        ASSERT_EQ(parser_state_parse(&b, entity.data(), entity.size()), parser_ok);
+        const std::string expectedB = renderState(&b);
+
+        // A page of an address of each state, then the next page: each state keeps its own cached value
+        char key[40];
+        char value[40];
+        char expectedValue[40];
+        uint8_t pageCount;
+        ASSERT_EQ(parser_state_getItem(&a, 3, key, sizeof(key), expectedValue, sizeof(expectedValue),
+                                       1, &pageCount), parser_ok);
+        ASSERT_EQ(parser_state_getItem(&a, 3, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+        ASSERT_EQ(parser_state_getItem(&b, 1, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+        ASSERT_EQ(parser_state_getItem(&a, 3, key, sizeof(key), value, sizeof(value), 1, &pageCount), parser_ok);
+        EXPECT_STREQ(key, "To");
+        EXPECT_STREQ(value, expectedValue);
+
+        EXPECT_EQ(renderState(&a), expectedA);
+        EXPECT_EQ(renderState(&b), expectedB);
+    }
+
+    TEST(ParserState, threads) {
+        std::vector<std::vector<uint8_t>> buffers;
+        std::vector<std::string> expected;
+        for (const auto &entry : corpus) {
+            buffers.push_back(decode(entry));
+            parser_state_t state;
+            expected.push_back(parser_state_parse(&state, buffers.back().data(), buffers.back().size()) == parser_ok
+                               ? renderState(&state) : "");
+        }
+
+        std::vector<int> mismatches(4, 0);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < mismatches.size(); t++) {
+            threads.emplace_back([&, t] {
+                parser_state_t state;
+                for (int round = 0; round < 50; round++) {
+                    for (size_t i = 0; i < buffers.size(); i++) {
+                        const size_t idx = (i + t) % buffers.size();
+                        const bool ok = parser_state_parse(&state, buffers[idx].data(), buffers[idx].size()) == parser_ok;
+                        if ((ok ? renderState(&state) : "") != expected[idx]) {
+                            mismatches[t]++;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        for (size_t t = 0; t < mismatches.size(); t++) {
+            EXPECT_EQ(mismatches[t], 0) << "thread " << t;
+        }
+    }
+    TEST(ParserState, itemPageCount) {
+        for (const auto &entry : corpus) {
+            const auto buffer = decode(entry);
+            parser_state_t state;
+            if (parser_state_parse(&state, buffer.data(), buffer.size()) != parser_ok) {
+                continue;
+            }
+
+            for (uint16_t width : {1, 2, 10, 17, 40, 200}) {
+                std::vector<char> value(width);
+                char key[40];
+                for (uint8_t idx = 0; idx < parser_state_getNumItems(&state); idx++) {
+                    const uint8_t planned = parser_state_getItemPageCount(&state, idx, width);
+
+                    uint8_t pageCount = 0;
+                    parser_state_getItem(&state, idx, key, sizeof(key), value.data(), width, 0, &pageCount);
+                    EXPECT_EQ(planned, pageCount) << entry.name << " item " << (int) idx << " width " << width;
+                    EXPECT_EQ(parser_state_getItemPageCount(&state, idx, width), pageCount) << entry.name;
+                }
+                EXPECT_EQ(parser_state_getItemPageCount(&state, parser_state_getNumItems(&state), width), 0);
+                EXPECT_EQ(parser_state_getItemPageCount(&state, -1, width), 0);
+            }
+        }
+    }
+
+    TEST(ParserState, pageCountKeepsCache) {
+        const auto transfer = decode(corpus[0]);
+        parser_state_t state;
+        ASSERT_EQ(parser_state_parse(&state, transfer.data(), transfer.size()), parser_ok);
+        const std::string expected = renderState(&state);
+
+        char key[40];
+        char value[40];
+        uint8_t pageCount;
+        ASSERT_EQ(parser_state_getItem(&state, 3, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+        for (uint8_t idx = 0; idx < parser_state_getNumItems(&state); idx++) {
+            parser_state_getItemPageCount(&state, idx, sizeof(value));
+        }
+        EXPECT_TRUE(state.renderCache.valid);
+        EXPECT_EQ(renderState(&state), expected);
+    }
+}
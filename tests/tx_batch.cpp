@@ -0,0 +1,176 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "parser.h"
+#include "tx_batch.h"
+#include "../benchmarks/corpus.h"
+
+namespace {
+    std::vector<uint8_t> corpusTx(const char *name) {
+        for (const auto &entry : corpus) {
+            if (strcmp(entry.name, name) == 0) {
+                std::vector<uint8_t> tx(strlen(entry.hex) / 2);
+                parseHexString(entry.hex, tx.data());
+                return tx;
+            }
+        }
+        ADD_FAILURE() << name;
+        return {};
+    }
+
+    void appendTx(std::vector<uint8_t> &batch, const std::vector<uint8_t> &tx) {
+        batch.push_back((uint8_t) (tx.size() >> 8u));
+        batch.push_back((uint8_t) tx.size());
+        batch.insert(batch.end(), tx.begin(), tx.end());
+    }
+
+    struct Item {
+        std::string key;
+        std::string value;
+    };
+
+    Item batchItem(tx_batch_t *batch, parser_context_t *ctx, const std::vector<uint8_t> &buffer, int8_t idx) {
+        char key[40];
+        char value[100];
+        uint8_t pageCount;
+        EXPECT_EQ(tx_batch_getItem(batch, ctx, buffer.data(), idx, key, sizeof(key), value, sizeof(value),
+                                   0, &pageCount), parser_ok) << (int) idx;
+        return {key, value};
+    }
+
+    TEST(TxBatch, reviewItems) {
+        const auto add = corpusTx("add_escrow");
+        const auto reclaim = corpusTx("reclaim_escrow");
+        std::vector<uint8_t> buffer;
+        appendTx(buffer, add);
+        appendTx(buffer, reclaim);
+
+        tx_batch_t batch;
+        parser_context_t ctx;
+        ASSERT_EQ(tx_batch_index(&batch, &ctx, buffer.data(), (uint16_t) buffer.size()), parser_ok);
+        ASSERT_EQ(batch.count, 2);
+        EXPECT_EQ(batch.entries[0].offset, TX_BATCH_LEN_SIZE);
+        EXPECT_EQ(batch.entries[0].len, add.size());
+        EXPECT_EQ(batch.entries[1].offset, 2 * TX_BATCH_LEN_SIZE + add.size());
+
+        const uint8_t addItems = batch.entries[0].numItems;
+        const uint8_t reclaimItems = batch.entries[1].numItems;
+        ASSERT_EQ(tx_batch_getNumItems(&batch), 1 + 2 + addItems + reclaimItems);
+
+        auto item = batchItem(&batch, &ctx, buffer, 0);
+        EXPECT_EQ(item.key, "Batch");
+        EXPECT_EQ(item.value, "2 transactions");
+
+        item = batchItem(&batch, &ctx, buffer, 1);
+        EXPECT_EQ(item.key, "Tx 1/2");
+        EXPECT_EQ(item.value, "Add escrow");
+        item = batchItem(&batch, &ctx, buffer, 2);
+        EXPECT_EQ(item.key, "Tx 2/2");
+        EXPECT_EQ(item.value, "Reclaim escrow");
+
+        // Each transaction shows the same items as when it is signed alone
+        const std::vector<const std::vector<uint8_t> *> txs = {&add, &reclaim};
+        int8_t displayIdx = 3;
+        for (uint8_t txIdx = 0; txIdx < 2; txIdx++) {
+            parser_context_t single;
+            ASSERT_EQ(parser_parse(&single, txs[txIdx]->data(), (uint16_t) txs[txIdx]->size()), parser_ok);
+            ASSERT_EQ(parser_getNumItems(&single), batch.entries[txIdx].numItems);
+
+            for (int8_t i = 0; i < parser_getNumItems(&single); i++) {
+                char key[40];
+                char value[100];
+                uint8_t pageCount;
+                ASSERT_EQ(parser_getItem(&single, i, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+                const std::string expectedKey = std::to_string(txIdx + 1) + "/2 " + key;
+                const std::string expectedValue = value;
+
+                item = batchItem(&batch, &ctx, buffer, displayIdx++);
+                EXPECT_EQ(item.key, expectedKey);
+                EXPECT_EQ(item.value, expectedValue);
+            }
+        }
+
+        char key[40];
+        char value[100];
+        uint8_t pageCount;
+        EXPECT_EQ(tx_batch_getItem(&batch, &ctx, buffer.data(), displayIdx, key, sizeof(key), value, sizeof(value),
+                                   0, &pageCount), parser_no_data);
+    }
+
+    TEST(TxBatch, itemPageCount) {
+        const auto add = corpusTx("add_escrow");
+        const auto reclaim = corpusTx("reclaim_escrow");
+        std::vector<uint8_t> buffer;
+        appendTx(buffer, add);
+        appendTx(buffer, reclaim);
+
+        tx_batch_t batch;
+        parser_context_t ctx;
+        ASSERT_EQ(tx_batch_index(&batch, &ctx, buffer.data(), (uint16_t) buffer.size()), parser_ok);
+
+        // Transactions are loaded in any order, the count is the one getItem gives
+        for (uint16_t width : {10, 17, 40}) {
+            for (int8_t idx = (int8_t) (tx_batch_getNumItems(&batch) - 1); idx >= 0; idx--) {
+                const uint8_t planned = tx_batch_getItemPageCount(&batch, &ctx, buffer.data(), idx, width);
+
+                char key[40];
+                std::vector<char> value(width);
+                uint8_t pageCount = 0;
+                ASSERT_EQ(tx_batch_getItem(&batch, &ctx, buffer.data(), idx, key, sizeof(key), value.data(), width,
+                                           0, &pageCount), parser_ok);
+                EXPECT_EQ(planned, pageCount) << (int) idx << " width " << width;
+            }
+        }
+        EXPECT_EQ(tx_batch_getItemPageCount(&batch, &ctx, buffer.data(), (int8_t) tx_batch_getNumItems(&batch), 17), 0);
+    }
+
+    TEST(TxBatch, errors) {
+        const auto add = corpusTx("add_escrow");
+        tx_batch_t batch;
+        parser_context_t ctx;
+
+        std::vector<uint8_t> buffer;
+        EXPECT_EQ(tx_batch_index(&batch, &ctx, buffer.data(), 0), parser_batch_empty);
+
+        // length without its transaction
+        appendTx(buffer, add);
+        buffer.pop_back();
+        EXPECT_EQ(tx_batch_index(&batch, &ctx, buffer.data(), (uint16_t) buffer.size()), parser_unexpected_buffer_end);
+
+        // zero length
+        buffer = {0, 0};
+        EXPECT_EQ(tx_batch_index(&batch, &ctx, buffer.data(), (uint16_t) buffer.size()), parser_unexpected_buffer_end);
+
+        // invalid transaction after a valid one
+        buffer.clear();
+        appendTx(buffer, add);
+        auto broken = add;
+        broken[broken.size() - 1] ^= 0xFF;
+        appendTx(buffer, broken);
+        EXPECT_NE(tx_batch_index(&batch, &ctx, buffer.data(), (uint16_t) buffer.size()), parser_ok);
+
+        buffer.clear();
+        for (int i = 0; i < TX_BATCH_MAX_TX; i++) {
+            appendTx(buffer, add);
+        }
+        EXPECT_EQ(tx_batch_index(&batch, &ctx, buffer.data(), (uint16_t) buffer.size()), parser_ok);
+        appendTx(buffer, add);
+        EXPECT_EQ(tx_batch_index(&batch, &ctx, buffer.data(), (uint16_t) buffer.size()), parser_batch_too_many_tx);
+    }
+}
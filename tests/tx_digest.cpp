@@ -0,0 +1,116 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+#include "lib/tx_digest.h"
+
+namespace {
+    std::vector<uint8_t> oneShot(const std::vector<uint8_t> &buffer) {
+        std::vector<uint8_t> digest(CX_SHA512_SIZE);
+        cx_sha512_t ctx;
+        cx_sha512_init(&ctx);
+        // Skip first byte (context length)
+        cx_hash(&ctx.header, CX_LAST, buffer.data() + 1, buffer.size() - 1, digest.data(), CX_SHA512_SIZE);
+        return digest;
+    }
+
+    std::vector<uint8_t> streamed(const std::vector<uint8_t> &buffer, size_t chunkLen) {
+        std::vector<uint8_t> digest(CX_SHA512_SIZE);
+        tx_digest_t txDigest;
+        tx_digest_init(&txDigest);
+        for (size_t offset = 0; offset < buffer.size(); offset += chunkLen) {
+            const size_t len = std::min(chunkLen, buffer.size() - offset);
+            tx_digest_append(&txDigest, offset, buffer.data() + offset, len);
+        }
+        tx_digest_final(&txDigest, buffer.data(), buffer.size(), digest.data());
+        return digest;
+    }
+
+    std::vector<uint8_t> makeBuffer(size_t len) {
+        std::vector<uint8_t> buffer(len);
+        for (size_t i = 0; i < len; i++) {
+            buffer[i] = (uint8_t) (i * 31 + 7);
+        }
+        return buffer;
+    }
+
+    TEST(TxDigest, HostSHA512) {
+        // FIPS 180-2 test vectors
+        uint8_t digest[CX_SHA512_SIZE];
+        cx_sha512_t ctx;
+
+        cx_sha512_init(&ctx);
+        cx_hash(&ctx.header, CX_LAST, (const uint8_t *) "abc", 3, digest, sizeof(digest));
+        EXPECT_EQ(std::vector<uint8_t>(digest, digest + sizeof(digest)), std::vector<uint8_t>({
+            0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba, 0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31,
+            0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2, 0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a,
+            0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8, 0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+            0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f}));
+
+        const char *twoBlocks = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                                "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+        cx_sha512_init(&ctx);
+        cx_hash(&ctx.header, CX_LAST, (const uint8_t *) twoBlocks, strlen(twoBlocks), digest, sizeof(digest));
+        EXPECT_EQ(std::vector<uint8_t>(digest, digest + sizeof(digest)), std::vector<uint8_t>({
+            0x8e, 0x95, 0x9b, 0x75, 0xda, 0xe3, 0x13, 0xda, 0x8c, 0xf4, 0xf7, 0x28, 0x14, 0xfc, 0x14, 0x3f,
+            0x8f, 0x77, 0x79, 0xc6, 0xeb, 0x9f, 0x7f, 0xa1, 0x72, 0x99, 0xae, 0xad, 0xb6, 0x88, 0x90, 0x18,
+            0x50, 0x1d, 0x28, 0x9e, 0x49, 0x00, 0xf7, 0xe4, 0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a,
+            0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54, 0x5e, 0x96, 0xe5, 0x5b, 0x87, 0x4b, 0xe9, 0x09}));
+    }
+
+    TEST(TxDigest, StreamingMatchesOneShot) {
+        // Sizes around the 128 byte SHA-512 block and the apdu chunk size
+        for (size_t len : {1, 2, 111, 112, 113, 128, 129, 130, 255, 256, 257, 1000, 8192}) {
+            const auto buffer = makeBuffer(len);
+            const auto expected = oneShot(buffer);
+            for (size_t chunkLen : {1, 7, 127, 128, 129, 250}) {
+                EXPECT_EQ(expected, streamed(buffer, chunkLen)) << "len " << len << " chunk " << chunkLen;
+            }
+        }
+    }
+
+    TEST(TxDigest, MissingChunkFallsBackToBuffer) {
+        const auto buffer = makeBuffer(600);
+
+        tx_digest_t txDigest;
+        tx_digest_init(&txDigest);
+        tx_digest_append(&txDigest, 0, buffer.data(), 250);
+        // skipped [250, 500)
+        tx_digest_append(&txDigest, 500, buffer.data() + 500, 100);
+
+        uint8_t digest[CX_SHA512_SIZE];
+        tx_digest_final(&txDigest, buffer.data(), buffer.size(), digest);
+        EXPECT_EQ(oneShot(buffer), std::vector<uint8_t>(digest, digest + sizeof(digest)));
+    }
+
+    TEST(TxDigest, FinalTwice) {
+        const auto buffer = makeBuffer(300);
+
+        tx_digest_t txDigest;
+        tx_digest_init(&txDigest);
+        tx_digest_append(&txDigest, 0, buffer.data(), buffer.size());
+
+        uint8_t first[CX_SHA512_SIZE];
+        uint8_t second[CX_SHA512_SIZE];
+        tx_digest_final(&txDigest, buffer.data(), buffer.size(), first);
+        tx_digest_final(&txDigest, buffer.data(), buffer.size(), second);
+        EXPECT_EQ(std::vector<uint8_t>(first, first + sizeof(first)), oneShot(buffer));
+        EXPECT_EQ(std::vector<uint8_t>(second, second + sizeof(second)), oneShot(buffer));
+    }
+}